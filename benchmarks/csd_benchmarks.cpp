@@ -0,0 +1,422 @@
+#include "captionicons.h"
+#include "csdiconcache.h"
+#include "csdresizezone.h"
+#include "csdstyleresources.h"
+#include "csdtitlebar.h"
+#include "csdtitlebarbutton.h"
+
+#include "csdtestsupport.h"
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+#include "linuxcsd.h"
+#endif
+
+#include <QtTest>
+
+#include <QHoverEvent>
+#include <QMoveEvent>
+#include <QPaintEvent>
+#include <QPixmap>
+#include <QWidget>
+
+#include <memory>
+#include <utility>
+
+using namespace CSD;
+using CSD::Test::showTitleBar;
+
+Q_DECLARE_METATYPE(CSD::CaptionButtonStyle)
+Q_DECLARE_METATYPE(CSD::TitleBar::Controls)
+Q_DECLARE_METATYPE(CSD::TitleBar::Rendering)
+
+// Hot paths of the title bar. Besides the timings, each benchmark checks the
+// counters the title bar keeps, so a change that makes a path do more work
+// fails here even when the timing noise hides it.
+class TitleBarBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void construction_data();
+    void construction();
+    void paintCaptionButton_data();
+    void paintCaptionButton();
+    void paintToolButton_data();
+    void paintToolButton();
+    void paintTitleBar_data();
+    void paintTitleBar();
+    void hoverCaptionButtons_data();
+    void hoverCaptionButtons();
+    void captionIconsForState();
+    void isCaptionAt();
+    void resizeZoneAt_data();
+    void resizeZoneAt();
+    void toggleActive();
+    void toggleMaximized();
+    void switchCaptionButtonStyle();
+    void filterUnhandledEvents_data();
+    void filterUnhandledEvents();
+
+private:
+    std::unique_ptr<Internal::StyleResources> m_styleResources;
+};
+
+void TitleBarBenchmark::initTestCase() {
+    Q_INIT_RESOURCE(csd);
+    // The mac glyphs come from the bundle built next to the benchmark
+    this->m_styleResources = std::make_unique<Internal::StyleResources>(
+        QCoreApplication::applicationDirPath());
+    QVERIFY(this->m_styleResources->activate(CaptionButtonStyle::mac));
+}
+
+static const auto renderings = {
+    std::make_pair("widgets", TitleBar::Rendering::Widgets),
+    std::make_pair("flyweight", TitleBar::Rendering::Flyweight)};
+
+void TitleBarBenchmark::construction_data() {
+    // The margin, the caption icon and the empty space are layout items;
+    // only the buttons and the progress strip are child widgets, and with
+    // flyweight rendering the caption buttons are layout items as well
+    QTest::addColumn<CaptionButtonStyle>("style");
+    QTest::addColumn<TitleBar::Controls>("controls");
+    QTest::addColumn<TitleBar::Rendering>("rendering");
+    QTest::addColumn<int>("childWidgets");
+    const auto styles = {std::make_pair("custom", CaptionButtonStyle::custom),
+                         std::make_pair("win", CaptionButtonStyle::win),
+                         std::make_pair("mac", CaptionButtonStyle::mac)};
+    for (const auto &style : styles) {
+        for (const auto &rendering : renderings) {
+            const int captionButtons =
+                rendering.second == TitleBar::Rendering::Widgets ? 3 : 0;
+            QTest::addRow("%s/caption-only/%s", style.first, rendering.first)
+                << style.second << TitleBar::Controls::CaptionOnly
+                << rendering.second << captionButtons;
+            QTest::addRow("%s/all/%s", style.first, rendering.first)
+                << style.second << TitleBar::Controls::All << rendering.second
+                << captionButtons + 10;
+        }
+    }
+}
+
+void TitleBarBenchmark::construction() {
+    QFETCH(CaptionButtonStyle, style);
+    QFETCH(TitleBar::Controls, controls);
+    QFETCH(TitleBar::Rendering, rendering);
+    QFETCH(int, childWidgets);
+    auto window = QWidget();
+    QBENCHMARK {
+        delete new TitleBar(style, QIcon(), &window, controls, rendering);
+    }
+
+    const auto titleBar = std::make_unique<TitleBar>(
+        style, QIcon(), &window, controls, rendering);
+    QCOMPARE(titleBar
+                 ->findChildren<QWidget *>(QString(),
+                                           Qt::FindDirectChildrenOnly)
+                 .size(),
+             childWidgets);
+}
+
+void TitleBarBenchmark::paintCaptionButton_data() {
+    QTest::addColumn<CaptionButtonStyle>("style");
+    QTest::addColumn<QString>("button");
+    const auto styles = {std::make_pair("custom", CaptionButtonStyle::custom),
+                         std::make_pair("win", CaptionButtonStyle::win),
+                         std::make_pair("mac", CaptionButtonStyle::mac)};
+    for (const auto &style : styles) {
+        for (const char *button :
+             {"ButtonMinimize", "ButtonMaximizeRestore", "ButtonClose"}) {
+            QTest::addRow("%s/%s", style.first, button)
+                << style.second << QString::fromLatin1(button);
+        }
+    }
+}
+
+void TitleBarBenchmark::paintCaptionButton() {
+    QFETCH(CaptionButtonStyle, style);
+    QFETCH(QString, button);
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window, style);
+    QVERIFY(titleBar != nullptr);
+    auto *titleBarButton =
+        titleBar->findChild<TitleBarButton *>(button);
+    QVERIFY(titleBarButton != nullptr);
+
+    auto target = QPixmap(titleBarButton->size());
+    titleBarButton->render(&target);
+    Internal::IconCache::instance().resetCounters();
+
+    QBENCHMARK {
+        titleBarButton->render(&target);
+    }
+
+    // Steady-state painting must never rasterize a glyph again
+    QCOMPARE(Internal::IconCache::instance().misses(), std::size_t(0));
+}
+
+void TitleBarBenchmark::paintToolButton_data() {
+    // Tool buttons blit their shadowed icons from the title bar's
+    // ToolIconCache in the normal, active and disabled icon modes. The
+    // design mode is disabled until a design editor is opened.
+    QTest::addColumn<QString>("button");
+    QTest::addColumn<bool>("keepDown");
+    QTest::addRow("normal") << QStringLiteral("ButtonModeEdit") << false;
+    QTest::addRow("keep-down") << QStringLiteral("ButtonModeEdit") << true;
+    QTest::addRow("disabled") << QStringLiteral("ButtonModeDesign") << false;
+}
+
+void TitleBarBenchmark::paintToolButton() {
+    QFETCH(QString, button);
+    QFETCH(bool, keepDown);
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(
+        window, CaptionButtonStyle::custom, TitleBar::Controls::All);
+    QVERIFY(titleBar != nullptr);
+    auto *titleBarButton = titleBar->findChild<TitleBarButton *>(button);
+    QVERIFY(titleBarButton != nullptr);
+    titleBarButton->setKeepDown(keepDown);
+    QCOMPARE(titleBarButton->isEnabled(), button != "ButtonModeDesign");
+
+    auto target = QPixmap(titleBarButton->size());
+    titleBarButton->render(&target);
+    const QImage first = target.toImage();
+
+    QBENCHMARK {
+        titleBarButton->render(&target);
+    }
+
+    // Every paint blits the same cached pixmap
+    QCOMPARE(target.toImage(), first);
+}
+
+void TitleBarBenchmark::paintTitleBar_data() {
+    QTest::addColumn<CaptionButtonStyle>("style");
+    QTest::addColumn<TitleBar::Rendering>("rendering");
+    const auto styles = {std::make_pair("custom", CaptionButtonStyle::custom),
+                         std::make_pair("win", CaptionButtonStyle::win),
+                         std::make_pair("mac", CaptionButtonStyle::mac)};
+    for (const auto &style : styles) {
+        for (const auto &rendering : renderings) {
+            QTest::addRow("%s/%s", style.first, rendering.first)
+                << style.second << rendering.second;
+        }
+    }
+}
+
+void TitleBarBenchmark::paintTitleBar() {
+    // The whole title bar, so the widget rows include painting the three
+    // caption button widgets and the flyweight rows painting them from the
+    // title bar's own paint event
+    QFETCH(CaptionButtonStyle, style);
+    QFETCH(TitleBar::Rendering, rendering);
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(
+        window, style, TitleBar::Controls::CaptionOnly, rendering);
+    QVERIFY(titleBar != nullptr);
+
+    auto target = QPixmap(titleBar->size());
+    titleBar->render(&target);
+    Internal::IconCache::instance().resetCounters();
+
+    QBENCHMARK {
+        titleBar->render(&target);
+    }
+
+    QCOMPARE(Internal::IconCache::instance().misses(), std::size_t(0));
+}
+
+void TitleBarBenchmark::hoverCaptionButtons_data() {
+    // Button widgets report leaving one button and entering the next
+    // separately, the flyweight title bar moves the hover in one step
+    QTest::addColumn<TitleBar::Rendering>("rendering");
+    QTest::addColumn<int>("hoverEvents");
+    QTest::addRow("widgets") << TitleBar::Rendering::Widgets << 6;
+    QTest::addRow("flyweight") << TitleBar::Rendering::Flyweight << 4;
+}
+
+void TitleBarBenchmark::hoverCaptionButtons() {
+    // Sweeps the mouse over the caption buttons and back to the empty space,
+    // which enters and leaves each of them once
+    QFETCH(TitleBar::Rendering, rendering);
+    QFETCH(int, hoverEvents);
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window,
+                                      CaptionButtonStyle::win,
+                                      TitleBar::Controls::CaptionOnly,
+                                      rendering);
+    QVERIFY(titleBar != nullptr);
+    const int width = titleBar->width();
+
+    std::size_t sweeps = 0;
+    QBENCHMARK {
+        for (int x = width - 3 * 46 - 8; x < width; x += 8) {
+            QTest::mouseMove(titleBar, QPoint(x, 15));
+        }
+        QTest::mouseMove(titleBar, QPoint(width / 2, 15));
+        ++sweeps;
+    }
+
+    QCOMPARE(titleBar->repaintCounters().events,
+             sweeps * static_cast<std::size_t>(hoverEvents));
+    QVERIFY(!titleBar->isCaptionButtonHovered());
+}
+
+void TitleBarBenchmark::captionIconsForState() {
+    std::size_t sum = 0;
+    QBENCHMARK {
+        for (std::size_t index = 0; index < Internal::captionStateCount;
+             ++index) {
+            const auto icons = Internal::captionIconsForState(
+                static_cast<CaptionButtonStyle>(index >> 4),
+                index & 8,
+                index & 4,
+                index & 2,
+                index & 1);
+            sum += static_cast<std::size_t>(icons[0]) +
+                   static_cast<std::size_t>(icons[2]);
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void TitleBarBenchmark::isCaptionAt() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window, CaptionButtonStyle::win);
+    QVERIFY(titleBar != nullptr);
+    const int width = titleBar->width();
+
+    std::size_t draggable = 0;
+    QBENCHMARK {
+        for (int x = 0; x < width; x += 4) {
+            draggable += titleBar->isCaptionAt(QPoint(x, 15));
+        }
+    }
+    QVERIFY(draggable > 0);
+}
+
+void TitleBarBenchmark::resizeZoneAt_data() {
+    // Mouse moves over a decorated window are mostly far from its borders,
+    // while resizing sweeps along them and reaches the corners
+    QTest::addColumn<int>("inset");
+    QTest::addRow("interior") << 100;
+    QTest::addRow("near-edges") << 0;
+}
+
+void TitleBarBenchmark::resizeZoneAt() {
+    QFETCH(int, inset);
+    const auto bounds = QRect(0, 0, 1280, 800);
+    constexpr int borderWidth = 6;
+    // Points on four rectangles 3 pixels apart, the outermost inset from
+    // the bounds; without inset they cross the border into the interior
+    const QRect path = bounds.adjusted(inset, inset, -inset, -inset);
+
+    std::size_t resizable = 0;
+    QBENCHMARK {
+        for (int offset = 0; offset < 2 * borderWidth; offset += 3) {
+            const QRect ring = path.adjusted(offset, offset, -offset, -offset);
+            for (int x = ring.left(); x <= ring.right(); x += 16) {
+                for (const int y : {ring.top(), ring.bottom()}) {
+                    resizable += Internal::resizeZoneAt(bounds,
+                                                        QPoint(x, y),
+                                                        borderWidth,
+                                                        true,
+                                                        true) !=
+                                 Internal::ResizeZone::None;
+                }
+            }
+            for (int y = ring.top(); y <= ring.bottom(); y += 16) {
+                for (const int x : {ring.left(), ring.right()}) {
+                    resizable += Internal::resizeZoneAt(bounds,
+                                                        QPoint(x, y),
+                                                        borderWidth,
+                                                        true,
+                                                        true) !=
+                                 Internal::ResizeZone::None;
+                }
+            }
+        }
+    }
+    QCOMPARE(resizable > 0, inset == 0);
+}
+
+void TitleBarBenchmark::toggleActive() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window, CaptionButtonStyle::custom);
+    QVERIFY(titleBar != nullptr);
+
+    std::size_t toggles = 0;
+    QBENCHMARK {
+        titleBar->setActive(false);
+        titleBar->setActive(true);
+        toggles += 2;
+    }
+
+    // Every custom glyph changes with activation, and nothing else repaints
+    QCOMPARE(titleBar->repaintCounters().events, toggles);
+    QCOMPARE(titleBar->repaintCounters().repaints, toggles * 3);
+}
+
+void TitleBarBenchmark::toggleMaximized() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window, CaptionButtonStyle::win);
+    QVERIFY(titleBar != nullptr);
+
+    std::size_t toggles = 0;
+    QBENCHMARK {
+        titleBar->setMaximized(true);
+        titleBar->setMaximized(false);
+        toggles += 2;
+    }
+
+    // Only the maximize/restore glyph depends on the window state
+    QCOMPARE(titleBar->repaintCounters().repaints, toggles);
+}
+
+void TitleBarBenchmark::switchCaptionButtonStyle() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window, CaptionButtonStyle::custom);
+    QVERIFY(titleBar != nullptr);
+
+    QBENCHMARK {
+        titleBar->setCaptionButtonStyle(CaptionButtonStyle::win);
+        titleBar->setCaptionButtonStyle(CaptionButtonStyle::mac);
+        titleBar->setCaptionButtonStyle(CaptionButtonStyle::custom);
+    }
+}
+
+void TitleBarBenchmark::filterUnhandledEvents_data() {
+    QTest::addColumn<bool>("filtered");
+    QTest::addRow("unfiltered") << false;
+    QTest::addRow("filtered") << true;
+}
+
+void TitleBarBenchmark::filterUnhandledEvents() {
+    // Events the decoration filter does not handle, sent at high rates to
+    // every decorated window; the filtered row should stay close to the
+    // unfiltered one
+    QFETCH(bool, filtered);
+    auto widget = QWidget();
+#if !defined(_WIN32) && !defined(__APPLE__)
+    auto filter = Internal::LinuxClientSideDecorationFilter();
+    if (filtered) {
+        filter.apply(&widget, []() {}, []() {});
+    }
+#else
+    if (filtered) {
+        QSKIP("Only the X11 decoration filter is part of csd_core here");
+    }
+#endif
+    auto paintEvent = QPaintEvent(QRect(0, 0, 10, 10));
+    auto moveEvent = QMoveEvent(QPoint(1, 1), QPoint(0, 0));
+    auto hoverEvent =
+        QHoverEvent(QEvent::HoverMove, QPointF(1.0, 1.0), QPointF(0.0, 0.0));
+
+    QBENCHMARK {
+        QCoreApplication::sendEvent(&widget, &paintEvent);
+        QCoreApplication::sendEvent(&widget, &moveEvent);
+        QCoreApplication::sendEvent(&widget, &hoverEvent);
+    }
+}
+
+QTEST_MAIN(TitleBarBenchmark)
+#include "csd_benchmarks.moc"
@@ -0,0 +1,306 @@
+#pragma once
+
+#include "captionbuttonstyle.h"
+
+#include <QStringView>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace CSD::Internal {
+
+// Interned IDs for all caption button glyphs. Glyphs loaded from resources
+// have their path in captionIconPaths; CMakeLists.txt verifies at configure
+// time that each of them is part of the bundle of its style.
+enum class CaptionIcon : std::uint8_t {
+    CustomMinimize,
+    CustomMinimizeDisabled,
+    CustomMaximize,
+    CustomMaximizeDisabled,
+    CustomRestore,
+    CustomRestoreDisabled,
+    CustomClose,
+    CustomCloseLight,
+    CustomCloseDisabled,
+    WinMinimize,
+    WinMinimizeDisabled,
+    WinMaximize,
+    WinMaximizeDisabled,
+    WinRestore,
+    WinRestoreDisabled,
+    WinClose,
+    WinCloseLight,
+    WinCloseDisabled,
+    MacMinimize,
+    MacMinimizeHovered,
+    MacMinimizePressed,
+    MacMaximizeRestore,
+    MacMaximizeRestoreNormalHovered,
+    MacMaximizeRestoreNormalPressed,
+    MacMaximizeRestoreMaximizedHovered,
+    MacMaximizeRestoreMaximizedPressed,
+    MacClose,
+    MacCloseHovered,
+    MacClosePressed,
+    MacInactive,
+    Count
+};
+
+constexpr std::size_t captionIconCount =
+    static_cast<std::size_t>(CaptionIcon::Count);
+
+constexpr std::array<QStringView, captionIconCount> captionIconPaths = {{
+    // The custom and win glyphs are drawn by CaptionGlyphEngine
+    u"", u"", u"", u"", u"", u"", u"", u"", u"",
+    u"", u"", u"", u"", u"", u"", u"", u"", u"",
+    u":/resources/titlebar/mac/minimize.png",
+    u":/resources/titlebar/mac/minimize-hovered.png",
+    u":/resources/titlebar/mac/minimize-pressed.png",
+    u":/resources/titlebar/mac/maximize-restore.png",
+    u":/resources/titlebar/mac/maximize-restore-normal-hovered.png",
+    u":/resources/titlebar/mac/maximize-restore-normal-pressed.png",
+    u":/resources/titlebar/mac/maximize-restore-maximized-hovered.png",
+    u":/resources/titlebar/mac/maximize-restore-maximized-pressed.png",
+    u":/resources/titlebar/mac/close.png",
+    u":/resources/titlebar/mac/close-hovered.png",
+    u":/resources/titlebar/mac/close-pressed.png",
+    u":/resources/titlebar/mac/inactive.png",
+}};
+
+using CaptionIcons = std::array<CaptionIcon, 3>;
+
+// Packs a caption button state into an index into captionIconTable:
+// bit 0 = pressed, bit 1 = hovered, bit 2 = maximized, bit 3 = active and
+// bits 4-5 = style
+constexpr std::size_t captionStateIndex(CaptionButtonStyle style,
+                                        bool active,
+                                        bool maximized,
+                                        bool hovered,
+                                        bool pressed) {
+    return (static_cast<std::size_t>(style) << 4) |
+           (static_cast<std::size_t>(active) << 3) |
+           (static_cast<std::size_t>(maximized) << 2) |
+           (static_cast<std::size_t>(hovered) << 1) |
+           static_cast<std::size_t>(pressed);
+}
+
+constexpr std::size_t captionStateCount = 3 << 4;
+
+// Icons for minimize, maximize/restore and close, indexed by
+// captionStateIndex
+constexpr std::array<CaptionIcons, captionStateCount> captionIconTable = {{
+    // custom, inactive, normal, unhovered, released
+    {{CaptionIcon::CustomMinimizeDisabled,
+      CaptionIcon::CustomMaximizeDisabled,
+      CaptionIcon::CustomCloseDisabled}},
+    // custom, inactive, normal, unhovered, pressed
+    {{CaptionIcon::CustomMinimizeDisabled,
+      CaptionIcon::CustomMaximizeDisabled,
+      CaptionIcon::CustomCloseDisabled}},
+    // custom, inactive, normal, hovered, released
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomMaximize,
+      CaptionIcon::CustomCloseLight}},
+    // custom, inactive, normal, hovered, pressed
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomMaximize,
+      CaptionIcon::CustomCloseLight}},
+    // custom, inactive, maximized, unhovered, released
+    {{CaptionIcon::CustomMinimizeDisabled,
+      CaptionIcon::CustomRestoreDisabled,
+      CaptionIcon::CustomCloseDisabled}},
+    // custom, inactive, maximized, unhovered, pressed
+    {{CaptionIcon::CustomMinimizeDisabled,
+      CaptionIcon::CustomRestoreDisabled,
+      CaptionIcon::CustomCloseDisabled}},
+    // custom, inactive, maximized, hovered, released
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomRestore,
+      CaptionIcon::CustomCloseLight}},
+    // custom, inactive, maximized, hovered, pressed
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomRestore,
+      CaptionIcon::CustomCloseLight}},
+    // custom, active, normal, unhovered, released
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomMaximize,
+      CaptionIcon::CustomClose}},
+    // custom, active, normal, unhovered, pressed
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomMaximize,
+      CaptionIcon::CustomClose}},
+    // custom, active, normal, hovered, released
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomMaximize,
+      CaptionIcon::CustomCloseLight}},
+    // custom, active, normal, hovered, pressed
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomMaximize,
+      CaptionIcon::CustomCloseLight}},
+    // custom, active, maximized, unhovered, released
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomRestore,
+      CaptionIcon::CustomClose}},
+    // custom, active, maximized, unhovered, pressed
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomRestore,
+      CaptionIcon::CustomClose}},
+    // custom, active, maximized, hovered, released
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomRestore,
+      CaptionIcon::CustomCloseLight}},
+    // custom, active, maximized, hovered, pressed
+    {{CaptionIcon::CustomMinimize,
+      CaptionIcon::CustomRestore,
+      CaptionIcon::CustomCloseLight}},
+    // win, inactive, normal, unhovered, released
+    {{CaptionIcon::WinMinimizeDisabled,
+      CaptionIcon::WinMaximizeDisabled,
+      CaptionIcon::WinCloseDisabled}},
+    // win, inactive, normal, unhovered, pressed
+    {{CaptionIcon::WinMinimizeDisabled,
+      CaptionIcon::WinMaximizeDisabled,
+      CaptionIcon::WinCloseDisabled}},
+    // win, inactive, normal, hovered, released
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinMaximize,
+      CaptionIcon::WinCloseLight}},
+    // win, inactive, normal, hovered, pressed
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinMaximize,
+      CaptionIcon::WinCloseLight}},
+    // win, inactive, maximized, unhovered, released
+    {{CaptionIcon::WinMinimizeDisabled,
+      CaptionIcon::WinRestoreDisabled,
+      CaptionIcon::WinCloseDisabled}},
+    // win, inactive, maximized, unhovered, pressed
+    {{CaptionIcon::WinMinimizeDisabled,
+      CaptionIcon::WinRestoreDisabled,
+      CaptionIcon::WinCloseDisabled}},
+    // win, inactive, maximized, hovered, released
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinRestore,
+      CaptionIcon::WinCloseLight}},
+    // win, inactive, maximized, hovered, pressed
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinRestore,
+      CaptionIcon::WinCloseLight}},
+    // win, active, normal, unhovered, released
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinMaximize,
+      CaptionIcon::WinClose}},
+    // win, active, normal, unhovered, pressed
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinMaximize,
+      CaptionIcon::WinClose}},
+    // win, active, normal, hovered, released
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinMaximize,
+      CaptionIcon::WinCloseLight}},
+    // win, active, normal, hovered, pressed
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinMaximize,
+      CaptionIcon::WinCloseLight}},
+    // win, active, maximized, unhovered, released
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinRestore,
+      CaptionIcon::WinClose}},
+    // win, active, maximized, unhovered, pressed
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinRestore,
+      CaptionIcon::WinClose}},
+    // win, active, maximized, hovered, released
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinRestore,
+      CaptionIcon::WinCloseLight}},
+    // win, active, maximized, hovered, pressed
+    {{CaptionIcon::WinMinimize,
+      CaptionIcon::WinRestore,
+      CaptionIcon::WinCloseLight}},
+    // mac, inactive, normal, unhovered, released
+    {{CaptionIcon::MacInactive,
+      CaptionIcon::MacInactive,
+      CaptionIcon::MacInactive}},
+    // mac, inactive, normal, unhovered, pressed
+    {{CaptionIcon::MacMinimizePressed,
+      CaptionIcon::MacMaximizeRestoreNormalPressed,
+      CaptionIcon::MacClosePressed}},
+    // mac, inactive, normal, hovered, released
+    {{CaptionIcon::MacMinimizeHovered,
+      CaptionIcon::MacMaximizeRestoreNormalHovered,
+      CaptionIcon::MacCloseHovered}},
+    // mac, inactive, normal, hovered, pressed
+    {{CaptionIcon::MacMinimizePressed,
+      CaptionIcon::MacMaximizeRestoreNormalPressed,
+      CaptionIcon::MacClosePressed}},
+    // mac, inactive, maximized, unhovered, released
+    {{CaptionIcon::MacInactive,
+      CaptionIcon::MacInactive,
+      CaptionIcon::MacInactive}},
+    // mac, inactive, maximized, unhovered, pressed
+    {{CaptionIcon::MacMinimizePressed,
+      CaptionIcon::MacMaximizeRestoreMaximizedPressed,
+      CaptionIcon::MacClosePressed}},
+    // mac, inactive, maximized, hovered, released
+    {{CaptionIcon::MacMinimizeHovered,
+      CaptionIcon::MacMaximizeRestoreMaximizedHovered,
+      CaptionIcon::MacCloseHovered}},
+    // mac, inactive, maximized, hovered, pressed
+    {{CaptionIcon::MacMinimizePressed,
+      CaptionIcon::MacMaximizeRestoreMaximizedPressed,
+      CaptionIcon::MacClosePressed}},
+    // mac, active, normal, unhovered, released
+    {{CaptionIcon::MacMinimize,
+      CaptionIcon::MacMaximizeRestore,
+      CaptionIcon::MacClose}},
+    // mac, active, normal, unhovered, pressed
+    {{CaptionIcon::MacMinimizePressed,
+      CaptionIcon::MacMaximizeRestoreNormalPressed,
+      CaptionIcon::MacClosePressed}},
+    // mac, active, normal, hovered, released
+    {{CaptionIcon::MacMinimizeHovered,
+      CaptionIcon::MacMaximizeRestoreNormalHovered,
+      CaptionIcon::MacCloseHovered}},
+    // mac, active, normal, hovered, pressed
+    {{CaptionIcon::MacMinimizePressed,
+      CaptionIcon::MacMaximizeRestoreNormalPressed,
+      CaptionIcon::MacClosePressed}},
+    // mac, active, maximized, unhovered, released
+    {{CaptionIcon::MacMinimize,
+      CaptionIcon::MacMaximizeRestore,
+      CaptionIcon::MacClose}},
+    // mac, active, maximized, unhovered, pressed
+    {{CaptionIcon::MacMinimizePressed,
+      CaptionIcon::MacMaximizeRestoreMaximizedPressed,
+      CaptionIcon::MacClosePressed}},
+    // mac, active, maximized, hovered, released
+    {{CaptionIcon::MacMinimizeHovered,
+      CaptionIcon::MacMaximizeRestoreMaximizedHovered,
+      CaptionIcon::MacCloseHovered}},
+    // mac, active, maximized, hovered, pressed
+    {{CaptionIcon::MacMinimizePressed,
+      CaptionIcon::MacMaximizeRestoreMaximizedPressed,
+      CaptionIcon::MacClosePressed}},
+}};
+
+constexpr CaptionIcons captionIconsForState(CaptionButtonStyle style,
+                                            bool active,
+                                            bool maximized,
+                                            bool hovered,
+                                            bool pressed) {
+    return captionIconTable[captionStateIndex(
+        style, active, maximized, hovered, pressed)];
+}
+
+constexpr QStringView captionIconPath(CaptionIcon icon) {
+    return captionIconPaths[static_cast<std::size_t>(icon)];
+}
+
+// Logical edge length of a glyph, the icon size of caption buttons in its
+// style
+constexpr int captionIconExtent(CaptionIcon icon) {
+    return icon >= CaptionIcon::MacMinimize ? 16 : 12;
+}
+
+} // namespace CSD::Internal
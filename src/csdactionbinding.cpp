@@ -0,0 +1,71 @@
+#include "csdactionbinding.h"
+
+#include "csdtitlebarbutton.h"
+
+#include <QAction>
+#include <QTimer>
+
+namespace CSD::Internal {
+
+ActionBinding::ActionBinding(TitleBarButton *button,
+                             Resolver resolver,
+                             IconSetter setIcon)
+    : QObject(button), m_button(button), m_resolver(std::move(resolver)),
+      m_setIcon(std::move(setIcon)) {
+    QObject::connect(this->m_button, &QPushButton::clicked, this, [this]() {
+        if (this->m_action != nullptr) {
+            this->m_action->trigger();
+        }
+    });
+}
+
+void ActionBinding::watch(QAction *action) {
+    QObject::connect(action, &QAction::changed, this, [this]() {
+        ++this->m_counters.received;
+        this->scheduleUpdate();
+    });
+}
+
+void ActionBinding::scheduleUpdate() {
+    if (this->m_updatePending) {
+        return;
+    }
+    this->m_updatePending = true;
+    QTimer::singleShot(0, this, [this]() { this->update(); });
+}
+
+void ActionBinding::update() {
+    this->m_updatePending = false;
+
+    const Target target = this->m_resolver();
+    this->m_action = target.action;
+
+    const bool enabled =
+        target.action != nullptr && target.action->isEnabled();
+    const qint64 iconCacheKey = target.icon.cacheKey();
+    if (this->m_hasApplied && enabled == this->m_enabled &&
+        iconCacheKey == this->m_iconCacheKey) {
+        return;
+    }
+
+    if (!this->m_hasApplied || enabled != this->m_enabled) {
+        this->m_button->setEnabled(enabled);
+    }
+    if (!this->m_hasApplied || iconCacheKey != this->m_iconCacheKey) {
+        this->m_setIcon(target.icon);
+    }
+    this->m_enabled = enabled;
+    this->m_iconCacheKey = iconCacheKey;
+    this->m_hasApplied = true;
+    ++this->m_counters.applied;
+}
+
+const ActionBindingCounters &ActionBinding::counters() const {
+    return this->m_counters;
+}
+
+void ActionBinding::resetCounters() {
+    this->m_counters = ActionBindingCounters();
+}
+
+} // namespace CSD::Internal
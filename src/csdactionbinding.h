@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QIcon>
+#include <QObject>
+#include <QPointer>
+
+#include <cstddef>
+#include <functional>
+
+class QAction;
+
+namespace CSD {
+
+class TitleBarButton;
+
+namespace Internal {
+
+// Number of QAction::changed notifications a binding received and number of
+// times it actually had to touch its button
+struct ActionBindingCounters {
+    std::size_t received = 0;
+    std::size_t applied = 0;
+};
+
+// Mirrors the enabled state and icon of a QAction on a tool button. Bursts of
+// changes are merged into one update per event loop iteration, only real
+// differences are applied, and clicks go through a single connection to
+// whichever action is current.
+class ActionBinding : public QObject {
+    Q_OBJECT
+
+public:
+    struct Target {
+        QAction *action;
+        QIcon icon;
+    };
+    using Resolver = std::function<Target()>;
+    using IconSetter = std::function<void(const QIcon &)>;
+
+    ActionBinding(TitleBarButton *button,
+                  Resolver resolver,
+                  IconSetter setIcon);
+    ~ActionBinding() override = default;
+
+    void watch(QAction *action);
+    void scheduleUpdate();
+    void update();
+
+    const ActionBindingCounters &counters() const;
+    void resetCounters();
+
+private:
+    TitleBarButton *m_button;
+    Resolver m_resolver;
+    IconSetter m_setIcon;
+    QPointer<QAction> m_action;
+    qint64 m_iconCacheKey = 0;
+    bool m_enabled = true;
+    bool m_hasApplied = false;
+    bool m_updatePending = false;
+    ActionBindingCounters m_counters;
+};
+
+} // namespace Internal
+} // namespace CSD
@@ -0,0 +1,258 @@
+#include "csdcaptionglyphengine.h"
+
+#include "csdtint.h"
+
+#include <QPainter>
+#include <QPolygonF>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace CSD::Internal {
+
+namespace {
+
+enum class Shape {
+    CustomMinimize,
+    CustomMaximize,
+    CustomRestore,
+    CustomClose,
+    WinMinimize,
+    WinMaximize,
+    WinRestore,
+    WinClose,
+    Count
+};
+
+struct Point {
+    qreal x;
+    qreal y;
+};
+
+struct Stroke {
+    std::array<Point, 6> points;
+    std::size_t count;
+    bool closed;
+};
+
+struct Glyph {
+    std::array<Stroke, 2> strokes;
+    std::size_t strokeCount;
+    qreal width;
+    Qt::PenCapStyle cap;
+    Qt::PenJoinStyle join;
+};
+
+enum class Tint { Normal, Light, Disabled };
+
+struct Variant {
+    Shape shape;
+    Tint tint;
+};
+
+} // namespace
+
+// Stroke center lines and widths in a unit square covering the icon, taken
+// from the SVG files the glyphs replace. Coordinates of 0 and 1 are line ends
+// on the edge of the icon.
+constexpr static std::array<Glyph, static_cast<std::size_t>(Shape::Count)>
+    glyphs = {{
+        // CustomMinimize
+        {{{{{{{0.06, 0.28}, {0.5, 0.71}, {0.94, 0.28}}}, 3, false}}},
+         1,
+         0.1,
+         Qt::RoundCap,
+         Qt::RoundJoin},
+        // CustomMaximize
+        {{{{{{{0.06, 0.72}, {0.5, 0.29}, {0.94, 0.72}}}, 3, false}}},
+         1,
+         0.1,
+         Qt::RoundCap,
+         Qt::RoundJoin},
+        // CustomRestore
+        {{{{{{{0.5, 0.05},
+               {0.93, 0.32},
+               {0.93, 0.68},
+               {0.5, 0.95},
+               {0.07, 0.68},
+               {0.07, 0.32}}},
+             6,
+             true}}},
+         1,
+         0.085,
+         Qt::RoundCap,
+         Qt::RoundJoin},
+        // CustomClose
+        {{{{{{{0.065, 0.065}, {0.935, 0.935}}}, 2, false},
+           {{{{0.935, 0.065}, {0.065, 0.935}}}, 2, false}}},
+         2,
+         0.13,
+         Qt::RoundCap,
+         Qt::RoundJoin},
+        // WinMinimize
+        {{{{{{{0, 0.45}, {1, 0.45}}}, 2, false}}},
+         1,
+         0.1,
+         Qt::FlatCap,
+         Qt::MiterJoin},
+        // WinMaximize
+        {{{{{{{0.05, 0.05}, {0.95, 0.05}, {0.95, 0.95}, {0.05, 0.95}}},
+             4,
+             true}}},
+         1,
+         0.1,
+         Qt::FlatCap,
+         Qt::MiterJoin},
+        // WinRestore
+        {{{{{{{0.05, 0.25}, {0.75, 0.25}, {0.75, 0.95}, {0.05, 0.95}}},
+             4,
+             true},
+           {{{{0.25, 0.2},
+              {0.25, 0.05},
+              {0.95, 0.05},
+              {0.95, 0.75},
+              {0.8, 0.75}}},
+            5,
+            false}}},
+         2,
+         0.1,
+         Qt::FlatCap,
+         Qt::MiterJoin},
+        // WinClose
+        {{{{{{{0.035, 0.035}, {0.965, 0.965}}}, 2, false},
+           {{{{0.965, 0.035}, {0.035, 0.965}}}, 2, false}}},
+         2,
+         0.1,
+         Qt::FlatCap,
+         Qt::MiterJoin},
+    }};
+
+// Indexed by CaptionIcon, up to the first mac glyph
+constexpr static std::array<Variant,
+                            static_cast<std::size_t>(CaptionIcon::MacMinimize)>
+    variants = {{
+        {Shape::CustomMinimize, Tint::Normal},
+        {Shape::CustomMinimize, Tint::Disabled},
+        {Shape::CustomMaximize, Tint::Normal},
+        {Shape::CustomMaximize, Tint::Disabled},
+        {Shape::CustomRestore, Tint::Normal},
+        {Shape::CustomRestore, Tint::Disabled},
+        {Shape::CustomClose, Tint::Normal},
+        {Shape::CustomClose, Tint::Light},
+        {Shape::CustomClose, Tint::Disabled},
+        {Shape::WinMinimize, Tint::Normal},
+        {Shape::WinMinimize, Tint::Disabled},
+        {Shape::WinMaximize, Tint::Normal},
+        {Shape::WinMaximize, Tint::Disabled},
+        {Shape::WinRestore, Tint::Normal},
+        {Shape::WinRestore, Tint::Disabled},
+        {Shape::WinClose, Tint::Normal},
+        {Shape::WinClose, Tint::Light},
+        {Shape::WinClose, Tint::Disabled},
+    }};
+
+bool CaptionGlyphColors::operator==(const CaptionGlyphColors &other) const {
+    return this->normal == other.normal && this->light == other.light &&
+           this->disabled == other.disabled;
+}
+
+bool CaptionGlyphColors::operator!=(const CaptionGlyphColors &other) const {
+    return !(*this == other);
+}
+
+bool CaptionGlyphEngine::draws(CaptionIcon icon) {
+    return static_cast<std::size_t>(icon) < variants.size();
+}
+
+CaptionIcon CaptionGlyphEngine::maskIcon(CaptionIcon icon) {
+    if (!draws(icon)) {
+        return icon;
+    }
+    const Shape shape = variants[static_cast<std::size_t>(icon)].shape;
+    std::size_t index = 0;
+    while (variants[index].shape != shape) {
+        ++index;
+    }
+    return static_cast<CaptionIcon>(index);
+}
+
+QRgb CaptionGlyphEngine::color(CaptionIcon icon,
+                               const CaptionGlyphColors &colors) {
+    if (!draws(icon)) {
+        return colors.normal;
+    }
+    switch (variants[static_cast<std::size_t>(icon)].tint) {
+    case Tint::Normal: {
+        return colors.normal;
+    }
+    case Tint::Light: {
+        return colors.light;
+    }
+    case Tint::Disabled: {
+        return colors.disabled;
+    }
+    }
+    return colors.normal;
+}
+
+QImage CaptionGlyphEngine::rasterizeMask(CaptionIcon icon,
+                                         const QSize &deviceSize) {
+    auto image = QImage(deviceSize, QImage::Format_Alpha8);
+    image.fill(0);
+    if (!draws(icon) || deviceSize.isEmpty()) {
+        return image;
+    }
+
+    const Variant &variant = variants[static_cast<std::size_t>(icon)];
+    const Glyph &glyph = glyphs[static_cast<std::size_t>(variant.shape)];
+
+    // The glyph fills the largest square centered in the image. Strokes of
+    // an odd pixel width are centered on pixel centers and even ones on
+    // pixel edges, which keeps horizontal and vertical lines sharp.
+    const int extent = std::min(deviceSize.width(), deviceSize.height());
+    const auto origin = QPointF((deviceSize.width() - extent) / 2,
+                                (deviceSize.height() - extent) / 2);
+    const qreal penWidth = std::max(1.0, std::round(glyph.width * extent));
+    const bool centerOnPixels = static_cast<int>(penWidth) % 2 == 1;
+    const auto snap = [extent, centerOnPixels](qreal value) -> qreal {
+        const qreal position = value * extent;
+        if (!centerOnPixels || value <= 0 || value >= 1) {
+            return std::round(position);
+        }
+        return std::floor(position) + 0.5;
+    };
+
+    {
+        auto painter = QPainter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(QPen(Qt::white,
+                            penWidth,
+                            Qt::SolidLine,
+                            glyph.cap,
+                            glyph.join));
+        painter.setBrush(Qt::NoBrush);
+        for (std::size_t index = 0; index < glyph.strokeCount; ++index) {
+            const Stroke &stroke = glyph.strokes[index];
+            auto polygon = QPolygonF();
+            for (std::size_t point = 0; point < stroke.count; ++point) {
+                polygon << origin + QPointF(snap(stroke.points[point].x),
+                                            snap(stroke.points[point].y));
+            }
+            if (stroke.closed) {
+                painter.drawPolygon(polygon);
+            } else {
+                painter.drawPolyline(polygon);
+            }
+        }
+    }
+    return image;
+}
+
+QImage CaptionGlyphEngine::rasterize(CaptionIcon icon,
+                                     const QSize &deviceSize,
+                                     const CaptionGlyphColors &colors) {
+    return tintMask(rasterizeMask(icon, deviceSize), color(icon, colors));
+}
+
+} // namespace CSD::Internal
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "captionicons.h"
+
+#include <QImage>
+#include <QRgb>
+#include <QSize>
+
+namespace CSD::Internal {
+
+// Foreground colors of the drawn caption glyphs. Light is used for the close
+// glyph on its hovered button and disabled for inactive windows.
+struct CaptionGlyphColors {
+    QRgb normal = 0xFFABB2BF;
+    QRgb light = 0xFFFFFFFF;
+    QRgb disabled = 0xFF5C6370;
+
+    bool operator==(const CaptionGlyphColors &other) const;
+    bool operator!=(const CaptionGlyphColors &other) const;
+};
+
+// Draws the caption glyphs of the custom and win styles from stroke geometry
+// instead of loading SVG files. Strokes are snapped to device pixels, so the
+// glyphs stay sharp at fractional scale factors. Each shape is drawn as an
+// alpha mask that is tinted in the glyph's color; the masks and pixmaps are
+// cached by IconCache.
+class CaptionGlyphEngine {
+public:
+    CaptionGlyphEngine() = delete;
+
+    static bool draws(CaptionIcon icon);
+    // The glyph whose mask is shared by icon, as the color variants of a
+    // shape differ only in their tint
+    static CaptionIcon maskIcon(CaptionIcon icon);
+    static QRgb color(CaptionIcon icon, const CaptionGlyphColors &colors);
+    static QImage rasterizeMask(CaptionIcon icon, const QSize &deviceSize);
+    static QImage rasterize(CaptionIcon icon,
+                            const QSize &deviceSize,
+                            const CaptionGlyphColors &colors = {});
+};
+
+} // namespace CSD::Internal
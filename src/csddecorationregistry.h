@@ -0,0 +1,123 @@
+#pragma once
+
+#include <QEvent>
+#include <QObject>
+#include <QWidget>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+#include <utility>
+
+namespace CSD::Internal {
+
+// Set of the built-in QEvent types a filter reacts to. Lookups are one shift
+// and one mask, so filters can reject uninteresting events before touching
+// any map.
+class EventTypeSet {
+public:
+    constexpr EventTypeSet(std::initializer_list<QEvent::Type> types) {
+        for (const QEvent::Type type : types) {
+            const auto index = static_cast<std::size_t>(type);
+            this->m_words[index / wordBits] |= std::uint64_t(1)
+                                               << (index % wordBits);
+        }
+    }
+
+    constexpr bool contains(QEvent::Type type) const {
+        const auto index = static_cast<std::size_t>(type);
+        return index < wordBits * wordCount &&
+               (this->m_words[index / wordBits] >> (index % wordBits)) & 1u;
+    }
+
+private:
+    constexpr static std::size_t wordBits = 64;
+    constexpr static std::size_t wordCount = 4;
+
+    std::array<std::uint64_t, wordCount> m_words{};
+};
+
+// Decorated top-level widgets with their per-window data, looked up in O(1)
+// by widget and by native window handle. Entries remove themselves when the
+// widget is destroyed; the handle has to be refreshed on WinIdChange.
+template <typename Data>
+class DecorationRegistry {
+public:
+    struct Entry {
+        QWidget *widget;
+        WId handle;
+        Data data;
+    };
+
+    // context owns the destroyed connection and must outlive the registry.
+    // Adding a widget again only replaces its data.
+    Entry &add(QWidget *widget, Data data, QObject *context) {
+        Entry *existing = this->find(widget);
+        if (existing != nullptr) {
+            existing->data = std::move(data);
+            this->updateHandle(widget);
+            return *existing;
+        }
+        const WId handle = widget->internalWinId();
+        auto result = this->m_entries.emplace(
+            widget, Entry{widget, handle, std::move(data)});
+        if (handle != 0) {
+            this->m_handles[handle] = widget;
+        }
+        QObject::connect(widget,
+                         &QObject::destroyed,
+                         context,
+                         [this](QObject *object) { this->remove(object); });
+        return result.first->second;
+    }
+
+    void remove(const QObject *widget) {
+        auto resultIterator = this->m_entries.find(widget);
+        if (resultIterator == std::end(this->m_entries)) {
+            return;
+        }
+        this->m_handles.erase(resultIterator->second.handle);
+        this->m_entries.erase(resultIterator);
+    }
+
+    void updateHandle(QWidget *widget) {
+        Entry *entry = this->find(widget);
+        if (entry == nullptr) {
+            return;
+        }
+        this->m_handles.erase(entry->handle);
+        entry->handle = widget->internalWinId();
+        if (entry->handle != 0) {
+            this->m_handles[entry->handle] = widget;
+        }
+    }
+
+    Entry *find(const QObject *widget) {
+        auto resultIterator = this->m_entries.find(widget);
+        return resultIterator != std::end(this->m_entries)
+                   ? &resultIterator->second
+                   : nullptr;
+    }
+
+    Entry *findByHandle(WId handle) {
+        auto resultIterator = this->m_handles.find(handle);
+        return resultIterator != std::end(this->m_handles)
+                   ? this->find(resultIterator->second)
+                   : nullptr;
+    }
+
+    template <typename Function>
+    void forEach(Function function) {
+        for (auto &pair : this->m_entries) {
+            function(pair.second);
+        }
+    }
+
+private:
+    std::unordered_map<const QObject *, Entry> m_entries;
+    std::unordered_map<WId, const QObject *> m_handles;
+};
+
+} // namespace CSD::Internal
@@ -0,0 +1,219 @@
+#include "csddiskiconcache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace CSD::Internal {
+
+// The file never leaves the machine, so it is written in native byte order.
+// The entry table follows the header, the pixel data of each entry starts on
+// a 16 byte boundary after it.
+struct FileHeader {
+    char magic[4];
+    quint32 version;
+    quint32 count;
+    quint32 reserved;
+};
+
+struct FileEntry {
+    quint64 key;
+    quint32 width;
+    quint32 height;
+    quint32 bytesPerLine;
+    quint32 reserved;
+    quint64 offset;
+};
+
+constexpr static char fileMagic[4] = {'C', 'S', 'D', 'I'};
+constexpr static quint32 fileFormatVersion = 1;
+constexpr static QImage::Format fileImageFormat =
+    QImage::Format_ARGB32_Premultiplied;
+// Caption glyphs are far smaller; anything larger comes from a broken file
+constexpr static quint64 maxImageExtent = 1024;
+
+static quint64 alignedOffset(quint64 offset) {
+    return (offset + 15) & ~quint64(15);
+}
+
+DiskIconCache::DiskIconCache(const QByteArray &fingerprint,
+                             qreal devicePixelRatio)
+    : m_devicePixelRatio(devicePixelRatio) {
+    const QByteArray name =
+        QCryptographicHash::hash(
+            fingerprint + '/' +
+                QByteArray::number(qRound(devicePixelRatio * 100)),
+            QCryptographicHash::Sha1)
+            .toHex()
+            .left(16);
+    const QString directory = QStandardPaths::writableLocation(
+        QStandardPaths::GenericCacheLocation);
+    this->m_path = directory + QStringLiteral("/qtcreator-csd/icons-") +
+                   QString::fromLatin1(name) + QStringLiteral(".cache");
+    this->map();
+}
+
+DiskIconCache::~DiskIconCache() {
+    // The mapped images must not outlive the mapping
+    this->m_images.clear();
+}
+
+QPixmap DiskIconCache::pixmap(std::uint64_t key) const {
+    auto resultIterator = this->m_images.find(key);
+    if (resultIterator == std::end(this->m_images)) {
+        return QPixmap();
+    }
+    // QPixmap::fromImage may share the image data instead of copying it, and
+    // the pixmap must stay valid once save() unmaps the file
+    auto pixmap = QPixmap::fromImage(resultIterator->second.copy());
+    pixmap.setDevicePixelRatio(this->m_devicePixelRatio);
+    return pixmap;
+}
+
+const QString &DiskIconCache::path() const {
+    return this->m_path;
+}
+
+void DiskIconCache::insert(std::uint64_t key, const QImage &image) {
+    if (image.isNull() ||
+        this->m_images.find(key) != std::end(this->m_images)) {
+        return;
+    }
+    this->m_images.emplace(key, image.convertToFormat(fileImageFormat));
+    this->m_dirty = true;
+}
+
+void DiskIconCache::save() {
+    if (!this->m_dirty) {
+        return;
+    }
+    QDir().mkpath(QFileInfo(this->m_path).absolutePath());
+
+    // QSaveFile writes to a temporary file and renames it over the old one
+    // on commit, so a concurrent reader never maps a partially written file
+    auto file = QSaveFile(this->m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    auto header = FileHeader();
+    std::memcpy(header.magic, fileMagic, sizeof(header.magic));
+    header.version = fileFormatVersion;
+    header.count = static_cast<quint32>(this->m_images.size());
+    header.reserved = 0;
+
+    auto entries = std::vector<FileEntry>();
+    entries.reserve(this->m_images.size());
+    quint64 offset = alignedOffset(sizeof(FileHeader) +
+                                   this->m_images.size() * sizeof(FileEntry));
+    for (const auto &[key, image] : this->m_images) {
+        entries.push_back(FileEntry{key,
+                                    static_cast<quint32>(image.width()),
+                                    static_cast<quint32>(image.height()),
+                                    static_cast<quint32>(image.bytesPerLine()),
+                                    0,
+                                    offset});
+        offset = alignedOffset(offset +
+                               static_cast<quint64>(image.sizeInBytes()));
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(entries.data()),
+               static_cast<qint64>(entries.size() * sizeof(FileEntry)));
+    auto entryIterator = std::begin(entries);
+    for (const auto &[key, image] : this->m_images) {
+        const qint64 padding =
+            static_cast<qint64>(entryIterator->offset) - file.pos();
+        file.write(QByteArray(static_cast<int>(padding), '\0'));
+        file.write(reinterpret_cast<const char *>(image.constBits()),
+                   static_cast<qint64>(image.sizeInBytes()));
+        ++entryIterator;
+    }
+
+    // Windows cannot replace a file that is still mapped, so the images are
+    // moved off the mapping first
+    this->unmap();
+    if (!file.commit()) {
+        qWarning("CSD: could not write the icon cache %s: %s",
+                 qPrintable(QDir::toNativeSeparators(this->m_path)),
+                 qPrintable(file.errorString()));
+        return;
+    }
+    this->m_dirty = false;
+}
+
+void DiskIconCache::unmap() {
+    if (!this->m_file.isOpen()) {
+        return;
+    }
+    for (auto &entry : this->m_images) {
+        entry.second = entry.second.copy();
+    }
+    // Closing the file drops its mappings
+    this->m_file.close();
+}
+
+void DiskIconCache::map() {
+    this->m_file.setFileName(this->m_path);
+    if (!this->m_file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const auto size = static_cast<quint64>(this->m_file.size());
+    if (size < sizeof(FileHeader)) {
+        return;
+    }
+    const uchar *data = this->m_file.map(0, static_cast<qint64>(size));
+    if (data == nullptr) {
+        return;
+    }
+
+    auto header = FileHeader();
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 ||
+        header.version != fileFormatVersion ||
+        header.count > (size - sizeof(FileHeader)) / sizeof(FileEntry)) {
+        return;
+    }
+
+    // A file that does not add up is ignored as a whole and replaced by the
+    // next save()
+    auto images = std::unordered_map<std::uint64_t, QImage>();
+    for (quint32 index = 0; index < header.count; ++index) {
+        auto entry = FileEntry();
+        std::memcpy(&entry,
+                    data + sizeof(FileHeader) + index * sizeof(FileEntry),
+                    sizeof(entry));
+        // Computed in 64 bits: with the extents bounded, none of these
+        // products can overflow
+        const quint64 width = entry.width;
+        const quint64 height = entry.height;
+        const quint64 bytesPerLine = entry.bytesPerLine;
+        if (width == 0 || height == 0 || width > maxImageExtent ||
+            height > maxImageExtent || bytesPerLine < width * 4 ||
+            bytesPerLine >
+                static_cast<quint64>(std::numeric_limits<int>::max()) ||
+            entry.offset % 4 != 0 || entry.offset > size ||
+            height * bytesPerLine > size - entry.offset) {
+            return;
+        }
+        // The read-only constructor keeps the image on the mapped bytes.
+        // Anything that detaches it, even setting the device pixel ratio,
+        // would copy them, so the ratio is applied to the pixmaps instead.
+        images.emplace(entry.key,
+                       QImage(data + entry.offset,
+                              static_cast<int>(entry.width),
+                              static_cast<int>(entry.height),
+                              static_cast<int>(entry.bytesPerLine),
+                              fileImageFormat));
+    }
+    this->m_images = std::move(images);
+}
+
+} // namespace CSD::Internal
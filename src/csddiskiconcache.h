@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QPixmap>
+#include <QString>
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace CSD::Internal {
+
+// Rasterized icons of one device pixel ratio, shared between Qt Creator
+// instances through a file in the XDG cache directory. The file name is
+// derived from the fingerprint, so a different plugin version, resource set
+// or theme never reads a stale file. Existing files are mapped read-only, so
+// only the icons actually looked up are copied out of them; save() replaces
+// the file atomically, so other instances see either the old or the new one.
+class DiskIconCache {
+public:
+    DiskIconCache(const QByteArray &fingerprint, qreal devicePixelRatio);
+    ~DiskIconCache();
+
+    DiskIconCache(const DiskIconCache &) = delete;
+    DiskIconCache &operator=(const DiskIconCache &) = delete;
+
+    QPixmap pixmap(std::uint64_t key) const;
+    const QString &path() const;
+    void insert(std::uint64_t key, const QImage &image);
+    void save();
+
+private:
+    void map();
+    void unmap();
+
+    qreal m_devicePixelRatio;
+    QString m_path;
+    QFile m_file;
+    // Images of the mapped file point into the mapping until unmap()
+    std::unordered_map<std::uint64_t, QImage> m_images;
+    bool m_dirty = false;
+};
+
+} // namespace CSD::Internal
@@ -0,0 +1,69 @@
+#include "csddragregion.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace CSD::Internal {
+
+void DragRegion::setBounds(const QRect &bounds) {
+    this->m_bounds = bounds;
+}
+
+void DragRegion::setInteractiveRects(std::vector<QRect> rects) {
+    const auto isEmpty = [](const QRect &rect) { return rect.isEmpty(); };
+    rects.erase(std::remove_if(std::begin(rects), std::end(rects), isEmpty),
+                std::end(rects));
+    std::sort(std::begin(rects),
+              std::end(rects),
+              [](const QRect &lhs, const QRect &rhs) {
+                  return lhs.left() < rhs.left();
+              });
+
+    this->m_maxRight.clear();
+    this->m_maxRight.reserve(rects.size());
+    int maxRight = std::numeric_limits<int>::min();
+    for (const QRect &rect : rects) {
+        maxRight = std::max(maxRight, rect.right());
+        this->m_maxRight.push_back(maxRight);
+    }
+    this->m_rects = std::move(rects);
+}
+
+void DragRegion::clear() {
+    this->m_bounds = QRect();
+    this->m_rects.clear();
+    this->m_maxRight.clear();
+}
+
+const QRect &DragRegion::bounds() const {
+    return this->m_bounds;
+}
+
+bool DragRegion::isInteractive(const QPoint &pos) const {
+    // Candidates start left of pos and end right of it. Both ends of that
+    // range are binary searches, as m_maxRight is sorted too. Title bar
+    // children are laid out side by side, so the range holds at most one
+    // rect unless they overlap.
+    const auto last = std::upper_bound(
+        std::begin(this->m_rects),
+        std::end(this->m_rects),
+        pos.x(),
+        [](int x, const QRect &rect) { return x < rect.left(); });
+    const auto firstRight = std::lower_bound(
+        std::begin(this->m_maxRight), std::end(this->m_maxRight), pos.x());
+    const auto first =
+        std::begin(this->m_rects) +
+        std::distance(std::begin(this->m_maxRight), firstRight);
+
+    return std::any_of(
+        first, std::max(first, last), [&pos](const QRect &rect) {
+            return rect.contains(pos);
+        });
+}
+
+bool DragRegion::isDraggable(const QPoint &pos) const {
+    return this->m_bounds.contains(pos) && !this->isInteractive(pos);
+}
+
+} // namespace CSD::Internal
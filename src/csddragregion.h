@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QPoint>
+#include <QRect>
+
+#include <vector>
+
+namespace CSD::Internal {
+
+// Answers whether a point of a title bar belongs to the draggable caption
+// area, i.e. lies inside the title bar but outside of all interactive rects.
+// The rects are sorted once when they change, so a query is a binary search
+// as long as they do not overlap horizontally.
+class DragRegion {
+public:
+    void setBounds(const QRect &bounds);
+    void setInteractiveRects(std::vector<QRect> rects);
+    void clear();
+
+    const QRect &bounds() const;
+    bool isInteractive(const QPoint &pos) const;
+    bool isDraggable(const QPoint &pos) const;
+
+private:
+    QRect m_bounds;
+    // Sorted by left edge; m_maxRight[i] is the largest right edge of the
+    // rects up to and including i, so it is sorted as well
+    std::vector<QRect> m_rects;
+    std::vector<int> m_maxRight;
+};
+
+} // namespace CSD::Internal
@@ -0,0 +1,109 @@
+#include "csdfadeanimator.h"
+
+#include <QLayoutItem>
+#include <QRegion>
+#include <QTimerEvent>
+#include <QWidget>
+
+#include <algorithm>
+
+namespace CSD::Internal {
+
+constexpr static int frameInterval = 16;
+
+FadeAnimator::FadeAnimator(QWidget *target, int duration)
+    : QObject(target), m_target(target),
+      m_step(1.0f / static_cast<float>(std::max(duration, 1))) {}
+
+FadeAnimator::Slot FadeAnimator::add(QWidget *widget) {
+    this->m_fades.push_back(Fade{widget, nullptr, 0.0f, 0.0f});
+    return this->m_fades.size() - 1;
+}
+
+FadeAnimator::Slot FadeAnimator::add(QLayoutItem *item) {
+    this->m_fades.push_back(Fade{nullptr, item, 0.0f, 0.0f});
+    return this->m_fades.size() - 1;
+}
+
+double FadeAnimator::value(Slot slot) const {
+    return static_cast<double>(this->m_fades[slot].value);
+}
+
+void FadeAnimator::setValue(Slot slot, double value) {
+    auto &fade = this->m_fades[slot];
+    if (fade.value != fade.target) {
+        --this->m_running;
+    }
+    fade.value = static_cast<float>(value);
+    fade.target = fade.value;
+    if (fade.widget != nullptr) {
+        fade.widget->update();
+    } else {
+        this->m_target->update(fade.item->geometry());
+    }
+}
+
+void FadeAnimator::fadeTo(Slot slot, double target) {
+    auto &fade = this->m_fades[slot];
+    const bool wasRunning = fade.value != fade.target;
+    fade.target = static_cast<float>(target);
+    const bool isRunning = fade.value != fade.target;
+
+    if (wasRunning && !isRunning) {
+        --this->m_running;
+    } else if (!wasRunning && isRunning) {
+        ++this->m_running;
+    }
+
+    if (this->m_running > 0 && !this->m_timer.isActive()) {
+        this->m_clock.start();
+        this->m_timer.start(frameInterval, Qt::PreciseTimer, this);
+    }
+}
+
+bool FadeAnimator::isRunning() const {
+    return this->m_running > 0;
+}
+
+void FadeAnimator::timerEvent(QTimerEvent *event) {
+    if (event->timerId() != this->m_timer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    const auto delta =
+        this->m_step * static_cast<float>(this->m_clock.restart());
+    auto dirty = QRegion();
+
+    for (auto &fade : this->m_fades) {
+        if (fade.value == fade.target) {
+            continue;
+        }
+        if (fade.value < fade.target) {
+            fade.value = std::min(fade.value + delta, fade.target);
+        } else {
+            fade.value = std::max(fade.value - delta, fade.target);
+        }
+        if (fade.value == fade.target) {
+            --this->m_running;
+        }
+        dirty += this->dirtyRect(fade);
+    }
+
+    if (!dirty.isEmpty()) {
+        this->m_target->update(dirty);
+    }
+
+    if (this->m_running == 0) {
+        this->m_timer.stop();
+    }
+}
+
+QRect FadeAnimator::dirtyRect(const Fade &fade) const {
+    if (fade.widget != nullptr) {
+        return fade.widget->isVisible() ? fade.widget->geometry() : QRect();
+    }
+    return fade.item->geometry();
+}
+
+} // namespace CSD::Internal
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QObject>
+
+#include <cstddef>
+#include <vector>
+
+class QLayoutItem;
+class QWidget;
+
+namespace CSD::Internal {
+
+// Drives the hover fades of all buttons of one title bar from a single frame
+// timer. Repaints of all buttons that changed during a frame are merged into
+// one update of the target widget, and the timer is stopped as soon as no
+// fade is running. Besides child widgets, layout items of the target can be
+// faded, for buttons the target paints itself.
+class FadeAnimator : public QObject {
+    Q_OBJECT
+
+public:
+    using Slot = std::size_t;
+
+    explicit FadeAnimator(QWidget *target, int duration = 125);
+    ~FadeAnimator() override = default;
+
+    Slot add(QWidget *widget);
+    Slot add(QLayoutItem *item);
+    double value(Slot slot) const;
+    void setValue(Slot slot, double value);
+    void fadeTo(Slot slot, double target);
+    bool isRunning() const;
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    struct Fade {
+        QWidget *widget;
+        QLayoutItem *item;
+        float value;
+        float target;
+    };
+
+    QRect dirtyRect(const Fade &fade) const;
+
+    QWidget *m_target;
+    float m_step;
+    std::vector<Fade> m_fades;
+    std::size_t m_running = 0;
+    QBasicTimer m_timer;
+    QElapsedTimer m_clock;
+};
+
+} // namespace CSD::Internal
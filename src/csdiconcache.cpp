@@ -0,0 +1,420 @@
+#include "csdiconcache.h"
+
+#include "captionicons.h"
+#include "csdcaptionglyphengine.h"
+#include "csddiskiconcache.h"
+#include "csdprerasterizer.h"
+#include "csdtint.h"
+
+#ifdef CSD_HAS_ATLAS
+#include "csdatlas.h"
+#endif
+
+#include <utils/stylehelper.h>
+#include <utils/theme/theme.h>
+
+#include <QCoreApplication>
+#include <QPainter>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace CSD::Internal {
+
+static std::uint64_t packGeometry(const QSize &size, qreal devicePixelRatio) {
+    const auto width = static_cast<std::uint64_t>(size.width()) & 0xFFFF;
+    const auto height = static_cast<std::uint64_t>(size.height()) & 0xFFFF;
+    const auto scale =
+        static_cast<std::uint64_t>(qRound(devicePixelRatio * 100)) & 0xFFFF;
+    return width | (height << 16) | (scale << 32);
+}
+
+static std::uint64_t captionPixmapKey(CaptionIcon icon,
+                                      const QSize &size,
+                                      qreal devicePixelRatio) {
+    return static_cast<std::uint64_t>(icon) |
+           (packGeometry(size, devicePixelRatio) << 8);
+}
+
+// Everything that changes the rasterized glyphs of a given size and device
+// pixel ratio. The glyph files are hashed at configure time, as only the
+// bundle of the selected style is registered at runtime.
+static QByteArray diskCacheFingerprint() {
+    return QByteArrayLiteral(CSD_VERSION "/" CSD_RESOURCE_HASH "/") +
+           Utils::creatorTheme()->id().toUtf8();
+}
+
+// Slices a glyph out of the atlas baked at build time. Returns a null pixmap
+// if it was not baked at this size and device pixel ratio.
+static QPixmap atlasPixmap([[maybe_unused]] CaptionIcon icon,
+                           [[maybe_unused]] const QSize &size,
+                           [[maybe_unused]] qreal devicePixelRatio) {
+#ifdef CSD_HAS_ATLAS
+    const int extent = captionIconExtent(icon);
+    if (size != QSize(extent, extent)) {
+        return QPixmap();
+    }
+    for (std::size_t scale = 0; scale < Atlas::scales.size(); ++scale) {
+        if (!qFuzzyCompare(Atlas::scales[scale], devicePixelRatio)) {
+            continue;
+        }
+        // The image only wraps the static pixels; nothing is decoded
+        const Atlas::Cell &cell =
+            Atlas::cells[scale][static_cast<std::size_t>(icon)];
+        const auto image =
+            QImage(Atlas::pixels + (cell.y * Atlas::width + cell.x) * 4,
+                   cell.width,
+                   cell.height,
+                   Atlas::width * 4,
+                   QImage::Format_ARGB32_Premultiplied);
+        auto pixmap = QPixmap::fromImage(image);
+        pixmap.setDevicePixelRatio(devicePixelRatio);
+        return pixmap;
+    }
+#endif
+    return QPixmap();
+}
+
+static std::size_t captionIconIndex(TitleBarButton::Role role) {
+    switch (role) {
+    case TitleBarButton::Minimize: {
+        return 0;
+    }
+    case TitleBarButton::MaximizeRestore: {
+        return 1;
+    }
+    default: {
+        return 2;
+    }
+    }
+}
+
+static QPixmap
+renderIcon(const QIcon &icon, const QSize &size, qreal devicePixelRatio) {
+    auto pixmap = QPixmap(size * devicePixelRatio);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    {
+        auto painter = QPainter(&pixmap);
+        icon.paint(&painter, QRect(QPoint(0, 0), size));
+    }
+    return pixmap;
+}
+
+bool IconKey::operator==(const IconKey &other) const {
+    return this->cacheKey == other.cacheKey &&
+           this->geometry == other.geometry;
+}
+
+std::size_t IconKeyHash::operator()(const IconKey &key) const {
+    const auto h1 = std::hash<qint64>()(key.cacheKey);
+    const auto h2 = std::hash<std::uint64_t>()(key.geometry);
+    return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+}
+
+bool TintKey::operator==(const TintKey &other) const {
+    return this->mask == other.mask && this->color == other.color;
+}
+
+std::size_t TintKeyHash::operator()(const TintKey &key) const {
+    const auto h1 = std::hash<std::uint64_t>()(key.mask);
+    const auto h2 = std::hash<QRgb>()(key.color);
+    return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+}
+
+IconCache &IconCache::instance() {
+    static IconCache cache;
+    return cache;
+}
+
+IconCache::IconCache() = default;
+
+IconCache::~IconCache() = default;
+
+QPixmap IconCache::captionButtonPixmap(CaptionButtonStyle style,
+                                       bool active,
+                                       bool maximized,
+                                       bool hovered,
+                                       bool pressed,
+                                       TitleBarButton::Role role,
+                                       const CaptionGlyphColors &colors,
+                                       const QSize &size,
+                                       qreal devicePixelRatio) {
+    const CaptionIcon icon = captionIconsForState(
+        style, active, maximized, hovered, pressed)[captionIconIndex(role)];
+    if (CaptionGlyphEngine::draws(icon)) {
+        return this->glyphPixmap(icon,
+                                 CaptionGlyphEngine::color(icon, colors),
+                                 size,
+                                 devicePixelRatio);
+    }
+
+    const std::uint64_t key = captionPixmapKey(icon, size, devicePixelRatio);
+
+    auto resultIterator = this->m_captionPixmaps.find(key);
+    if (resultIterator != std::end(this->m_captionPixmaps)) {
+        ++this->m_hits;
+        return resultIterator->second;
+    }
+
+    ++this->m_misses;
+    auto pixmap = atlasPixmap(icon, size, devicePixelRatio);
+    if (pixmap.isNull()) {
+        pixmap = renderIcon(
+            QIcon(captionIconPath(icon).toString()), size, devicePixelRatio);
+    }
+    if (!this->m_shutDown) {
+        this->m_captionPixmaps.emplace(key, pixmap);
+    }
+    return pixmap;
+}
+
+QPixmap IconCache::iconPixmap(const QIcon &icon,
+                              const QSize &size,
+                              qreal devicePixelRatio) {
+    if (icon.isNull()) {
+        return QPixmap();
+    }
+
+    const auto key =
+        IconKey{icon.cacheKey(), packGeometry(size, devicePixelRatio)};
+
+    auto resultIterator = this->m_iconPixmaps.find(key);
+    if (resultIterator != std::end(this->m_iconPixmaps)) {
+        ++this->m_hits;
+        return resultIterator->second;
+    }
+
+    ++this->m_misses;
+    auto pixmap = renderIcon(icon, size, devicePixelRatio);
+    if (!this->m_shutDown) {
+        this->m_iconPixmaps.emplace(key, pixmap);
+    }
+    return pixmap;
+}
+
+void IconCache::prerasterize(CaptionButtonStyle style,
+                             const QSize &size,
+                             qreal devicePixelRatio) {
+    if (this->m_shutDown) {
+        return;
+    }
+    if (this->m_prerasterizer.isNull()) {
+        this->m_prerasterizer = new Prerasterizer(
+            [this](std::uint64_t key,
+                   const QImage &image,
+                   const QPixmap &pixmap) {
+                this->m_queuedKeys.erase(key);
+                // A glyph painted before its job finished is kept
+                if (!image.isNull()) {
+                    this->m_captionPixmaps.emplace(key, pixmap);
+                    this->diskCache(image.devicePixelRatio())
+                        .insert(key, image);
+                }
+                if (this->m_pendingJobs > 0 && --this->m_pendingJobs == 0) {
+                    this->saveDiskCaches();
+                }
+            },
+            QCoreApplication::instance());
+    }
+
+    // The active window's glyphs are shown first and inactive ones as soon
+    // as another window takes the focus. Hovered glyphs follow and pressed
+    // ones are needed rarely, so they are queued in that order.
+    auto priorities = std::array<int, captionIconCount>();
+    priorities.fill(-1);
+    for (const bool active : {false, true}) {
+        for (const bool maximized : {false, true}) {
+            for (const bool hovered : {false, true}) {
+                for (const bool pressed : {false, true}) {
+                    const int priority =
+                        pressed ? 0 : (hovered ? 1 : (active ? 3 : 2));
+                    for (const CaptionIcon icon : captionIconsForState(
+                             style, active, maximized, hovered, pressed)) {
+                        auto &slot =
+                            priorities[static_cast<std::size_t>(icon)];
+                        slot = std::max(slot, priority);
+                    }
+                }
+            }
+        }
+    }
+
+    DiskIconCache &diskCache = this->diskCache(devicePixelRatio);
+    auto jobs = std::vector<Prerasterizer::Job>();
+    for (std::size_t index = 0; index < captionIconCount; ++index) {
+        const auto icon = static_cast<CaptionIcon>(index);
+        const std::uint64_t key =
+            captionPixmapKey(icon, size, devicePixelRatio);
+        // Drawn glyphs are only a few strokes, painting and tinting them on
+        // first use is cheaper than a round trip through the pool
+        if (priorities[index] < 0 || CaptionGlyphEngine::draws(icon) ||
+            this->m_captionPixmaps.find(key) !=
+                std::end(this->m_captionPixmaps) ||
+            this->m_queuedKeys.count(key) != 0) {
+            continue;
+        }
+        auto pixmap = atlasPixmap(icon, size, devicePixelRatio);
+        if (!pixmap.isNull()) {
+            this->m_captionPixmaps.emplace(key, std::move(pixmap));
+            continue;
+        }
+        pixmap = diskCache.pixmap(key);
+        if (!pixmap.isNull()) {
+            this->m_captionPixmaps.emplace(key, std::move(pixmap));
+            continue;
+        }
+        this->m_queuedKeys.insert(key);
+        jobs.push_back(Prerasterizer::Job{key,
+                                          captionIconPath(icon).toString(),
+                                          size,
+                                          devicePixelRatio,
+                                          priorities[index]});
+    }
+    this->m_pendingJobs += jobs.size();
+    this->m_prerasterizer->start(jobs);
+}
+
+void IconCache::saveDiskCaches() {
+    for (const auto &entry : this->m_diskCaches) {
+        entry.second->save();
+    }
+}
+
+DiskIconCache &IconCache::diskCache(qreal devicePixelRatio) {
+    const int scale = qRound(devicePixelRatio * 100);
+    auto resultIterator = this->m_diskCaches.find(scale);
+    if (resultIterator == std::end(this->m_diskCaches)) {
+        static const QByteArray fingerprint = diskCacheFingerprint();
+        resultIterator =
+            this->m_diskCaches
+                .emplace(scale,
+                         std::make_unique<DiskIconCache>(fingerprint,
+                                                         devicePixelRatio))
+                .first;
+    }
+    return *resultIterator->second;
+}
+
+QPixmap IconCache::glyphPixmap(CaptionIcon icon,
+                               QRgb color,
+                               const QSize &size,
+                               qreal devicePixelRatio) {
+    const std::uint64_t maskKey = captionPixmapKey(
+        CaptionGlyphEngine::maskIcon(icon), size, devicePixelRatio);
+    const auto key = TintKey{maskKey, color};
+
+    auto resultIterator = this->m_glyphPixmaps.find(key);
+    if (resultIterator != std::end(this->m_glyphPixmaps)) {
+        ++this->m_hits;
+        return resultIterator->second;
+    }
+
+    ++this->m_misses;
+    // The atlas holds the glyphs in their default colors only
+    auto pixmap =
+        color == CaptionGlyphEngine::color(icon, CaptionGlyphColors())
+            ? atlasPixmap(icon, size, devicePixelRatio)
+            : QPixmap();
+    if (pixmap.isNull()) {
+        auto maskIterator = this->m_glyphMasks.find(maskKey);
+        const QImage mask =
+            maskIterator != std::end(this->m_glyphMasks)
+                ? maskIterator->second
+                : CaptionGlyphEngine::rasterizeMask(
+                      icon, size * devicePixelRatio);
+        if (maskIterator == std::end(this->m_glyphMasks) &&
+            !this->m_shutDown) {
+            this->m_glyphMasks.emplace(maskKey, mask);
+        }
+        pixmap = QPixmap::fromImage(tintMask(mask, color));
+        pixmap.setDevicePixelRatio(devicePixelRatio);
+    }
+    if (!this->m_shutDown) {
+        this->m_glyphPixmaps.emplace(key, pixmap);
+    }
+    return pixmap;
+}
+
+std::size_t IconCache::hits() const {
+    return this->m_hits;
+}
+
+std::size_t IconCache::misses() const {
+    return this->m_misses;
+}
+
+void IconCache::resetCounters() {
+    this->m_hits = 0;
+    this->m_misses = 0;
+}
+
+std::size_t IconCache::size() const {
+    return this->m_captionPixmaps.size() + this->m_glyphMasks.size() +
+           this->m_glyphPixmaps.size() + this->m_iconPixmaps.size();
+}
+
+void IconCache::clear() {
+    delete this->m_prerasterizer.data();
+    this->m_pendingJobs = 0;
+    this->m_queuedKeys.clear();
+    this->m_diskCaches.clear();
+    this->m_captionPixmaps.clear();
+    this->m_glyphMasks.clear();
+    this->m_glyphPixmaps.clear();
+    this->m_iconPixmaps.clear();
+}
+
+void IconCache::shutDown() {
+    this->clear();
+    this->m_shutDown = true;
+}
+
+QPixmap ToolIconCache::pixmap(const QIcon &icon,
+                              QIcon::Mode mode,
+                              const QRect &iconRect,
+                              const QSize &size,
+                              qreal devicePixelRatio) {
+    // The icon rect is derived from the button size by the caller, so the
+    // button size together with the mode identifies the finished pixmap
+    const auto key =
+        IconKey{icon.cacheKey(),
+                packGeometry(size, devicePixelRatio) |
+                    (static_cast<std::uint64_t>(mode) << 48)};
+
+    auto resultIterator = this->m_pixmaps.find(key);
+    if (resultIterator != std::end(this->m_pixmaps)) {
+        return resultIterator->second;
+    }
+
+    auto pixmap = QPixmap(size * devicePixelRatio);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    {
+        auto painter = QPainter(&pixmap);
+        Utils::StyleHelper::drawIconWithShadow(
+            icon, iconRect, &painter, mode);
+    }
+    this->m_pixmaps.emplace(key, pixmap);
+    return pixmap;
+}
+
+void ToolIconCache::invalidate(qint64 cacheKey) {
+    for (auto it = std::begin(this->m_pixmaps);
+         it != std::end(this->m_pixmaps);) {
+        if (it->first.cacheKey == cacheKey) {
+            it = this->m_pixmaps.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ToolIconCache::clear() {
+    this->m_pixmaps.clear();
+}
+
+} // namespace CSD::Internal
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "captionbuttonstyle.h"
+#include "csdcaptionglyphengine.h"
+#include "csdtitlebarbutton.h"
+
+#include <QIcon>
+#include <QImage>
+#include <QPixmap>
+#include <QPointer>
+#include <QRect>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace CSD::Internal {
+
+class DiskIconCache;
+class Prerasterizer;
+
+struct IconKey {
+    qint64 cacheKey;
+    std::uint64_t geometry;
+    bool operator==(const IconKey &other) const;
+};
+
+struct IconKeyHash {
+    std::size_t operator()(const IconKey &key) const;
+};
+
+struct TintKey {
+    std::uint64_t mask;
+    QRgb color;
+    bool operator==(const TintKey &other) const;
+};
+
+struct TintKeyHash {
+    std::size_t operator()(const TintKey &key) const;
+};
+
+class IconCache {
+public:
+    static IconCache &instance();
+
+    ~IconCache();
+
+    IconCache(const IconCache &) = delete;
+    IconCache &operator=(const IconCache &) = delete;
+
+    QPixmap captionButtonPixmap(CaptionButtonStyle style,
+                                bool active,
+                                bool maximized,
+                                bool hovered,
+                                bool pressed,
+                                TitleBarButton::Role role,
+                                const CaptionGlyphColors &colors,
+                                const QSize &size,
+                                qreal devicePixelRatio);
+    QPixmap iconPixmap(const QIcon &icon,
+                       const QSize &size,
+                       qreal devicePixelRatio);
+
+    // Renders every caption glyph of style in the background so that no
+    // state has to be decoded on the GUI thread when it is first shown.
+    // Glyphs baked into the atlas or left in the disk cache by another Qt
+    // Creator instance are taken from there instead.
+    void prerasterize(CaptionButtonStyle style,
+                      const QSize &size,
+                      qreal devicePixelRatio);
+    void saveDiskCaches();
+
+    std::size_t hits() const;
+    std::size_t misses() const;
+    void resetCounters();
+    // Number of cached pixmaps and glyph masks
+    std::size_t size() const;
+    // Drops all pixmaps, waits for the background rasterization and unmaps
+    // the disk caches.
+    void clear();
+    // The cache outlives QApplication as a function-local static, so it is
+    // cleared while the application still exists. Windows may still repaint
+    // afterwards; from then on lookups render uncached pixmaps and
+    // prerasterize() does nothing.
+    void shutDown();
+
+private:
+    IconCache();
+
+    DiskIconCache &diskCache(qreal devicePixelRatio);
+    QPixmap glyphPixmap(CaptionIcon icon,
+                        QRgb color,
+                        const QSize &size,
+                        qreal devicePixelRatio);
+
+    std::unordered_map<std::uint64_t, QPixmap> m_captionPixmaps;
+    // Drawn glyphs keep one mask per shape and size and one pixmap per color
+    std::unordered_map<std::uint64_t, QImage> m_glyphMasks;
+    std::unordered_map<TintKey, QPixmap, TintKeyHash> m_glyphPixmaps;
+    QPointer<Prerasterizer> m_prerasterizer;
+    std::size_t m_pendingJobs = 0;
+    // Keys of jobs handed to the prerasterizer and not delivered yet, so
+    // that title bars created in a row do not queue the same glyphs again
+    std::unordered_set<std::uint64_t> m_queuedKeys;
+    std::unordered_map<int, std::unique_ptr<DiskIconCache>> m_diskCaches;
+    std::unordered_map<IconKey, QPixmap, IconKeyHash> m_iconPixmaps;
+    std::size_t m_hits = 0;
+    std::size_t m_misses = 0;
+    bool m_shutDown = false;
+};
+
+// Finished tool button pixmaps, including the blurred shadow drawn by
+// Utils::StyleHelper::drawIconWithShadow. Each title bar owns one; entries of
+// an icon are dropped with invalidate() once a bound action replaces it.
+class ToolIconCache {
+public:
+    QPixmap pixmap(const QIcon &icon,
+                   QIcon::Mode mode,
+                   const QRect &iconRect,
+                   const QSize &size,
+                   qreal devicePixelRatio);
+    void invalidate(qint64 cacheKey);
+    void clear();
+
+private:
+    std::unordered_map<IconKey, QPixmap, IconKeyHash> m_pixmaps;
+};
+
+} // namespace CSD::Internal
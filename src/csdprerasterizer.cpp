@@ -0,0 +1,137 @@
+#include "csdprerasterizer.h"
+
+#include <QFile>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QPixmap>
+#include <QRunnable>
+#include <QThread>
+#include <QtMath>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace CSD::Internal {
+
+constexpr static std::size_t batchSize = 4;
+
+namespace {
+
+class RasterizeTask : public QRunnable {
+public:
+    RasterizeTask(Prerasterizer *prerasterizer, Prerasterizer::Job job)
+        : m_prerasterizer(prerasterizer), m_job(std::move(job)) {}
+
+    void run() override {
+        // Like QIcon, read the @Nx variant closest to the device pixel ratio
+        // from above, keep the aspect ratio and center the glyph
+        const QSize extent = this->m_job.size * this->m_job.devicePixelRatio;
+        auto reader = QImageReader(sourcePath(this->m_job.path,
+                                              this->m_job.devicePixelRatio));
+        reader.setScaledSize(
+            reader.size().scaled(extent, Qt::KeepAspectRatio));
+        const QImage pixels = reader.read();
+        if (pixels.isNull()) {
+            // Still reported, so that the pending job count drains
+            this->m_prerasterizer->finish(this->m_job.key, QImage());
+            return;
+        }
+
+        auto image = QImage(extent, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        auto target = QRect(QPoint(0, 0), pixels.size());
+        target.moveCenter(image.rect().center());
+        {
+            auto painter = QPainter(&image);
+            painter.drawImage(target.topLeft(), pixels);
+        }
+        image.setDevicePixelRatio(this->m_job.devicePixelRatio);
+        this->m_prerasterizer->finish(this->m_job.key, std::move(image));
+    }
+
+private:
+    static QString sourcePath(const QString &path, qreal devicePixelRatio) {
+        const int dot = path.lastIndexOf(QLatin1Char('.'));
+        for (int n = qCeil(devicePixelRatio); n > 1; --n) {
+            QString candidate = path;
+            candidate.insert(dot, QStringLiteral("@%1x").arg(n));
+            if (QFile::exists(candidate)) {
+                return candidate;
+            }
+        }
+        return path;
+    }
+
+    Prerasterizer *m_prerasterizer;
+    Prerasterizer::Job m_job;
+};
+
+} // namespace
+
+Prerasterizer::Prerasterizer(Sink sink, QObject *parent)
+    : QObject(parent), m_sink(std::move(sink)) {
+    // Leave one core to the GUI thread
+    this->m_pool.setMaxThreadCount(
+        std::max(QThread::idealThreadCount() - 1, 1));
+}
+
+Prerasterizer::~Prerasterizer() {
+    this->m_pool.clear();
+    this->m_pool.waitForDone();
+}
+
+void Prerasterizer::start(const std::vector<Job> &jobs) {
+    for (const Job &job : jobs) {
+        this->m_pool.start(new RasterizeTask(this, job), job.priority);
+    }
+}
+
+std::size_t Prerasterizer::delivered() const {
+    return this->m_delivered;
+}
+
+void Prerasterizer::finish(std::uint64_t key, QImage image) {
+    auto locker = QMutexLocker(&this->m_mutex);
+    this->m_results.push_back(Result{key, std::move(image)});
+    if (this->m_drainScheduled) {
+        return;
+    }
+    this->m_drainScheduled = true;
+    QMetaObject::invokeMethod(
+        this, [this]() { this->drain(); }, Qt::QueuedConnection);
+}
+
+void Prerasterizer::drain() {
+    auto batch = std::vector<Result>();
+    {
+        auto locker = QMutexLocker(&this->m_mutex);
+        const std::size_t count = std::min(batchSize, this->m_results.size());
+        std::move(std::begin(this->m_results),
+                  std::begin(this->m_results) +
+                      static_cast<std::ptrdiff_t>(count),
+                  std::back_inserter(batch));
+        this->m_results.erase(std::begin(this->m_results),
+                              std::begin(this->m_results) +
+                                  static_cast<std::ptrdiff_t>(count));
+        this->m_drainScheduled = !this->m_results.empty();
+        if (this->m_drainScheduled) {
+            QMetaObject::invokeMethod(
+                this, [this]() { this->drain(); }, Qt::QueuedConnection);
+        }
+    }
+
+    for (const Result &result : batch) {
+        if (result.image.isNull()) {
+            this->m_sink(result.key, result.image, QPixmap());
+            continue;
+        }
+        this->m_sink(
+            result.key, result.image, QPixmap::fromImage(result.image));
+        ++this->m_delivered;
+    }
+}
+
+} // namespace CSD::Internal
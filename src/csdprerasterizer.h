@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class QPixmap;
+
+namespace CSD::Internal {
+
+// Decodes image files to QImages on a private thread pool and hands them to
+// the GUI thread as pixmaps, a few per event loop iteration so that the
+// conversion never stalls painting. Jobs with a higher priority are started
+// first. Every job reaches the sink exactly once; files that cannot be read
+// arrive as a null image and pixmap.
+class Prerasterizer : public QObject {
+    Q_OBJECT
+
+public:
+    struct Job {
+        std::uint64_t key;
+        QString path;
+        QSize size;
+        qreal devicePixelRatio;
+        int priority;
+    };
+    using Sink = std::function<void(
+        std::uint64_t key, const QImage &image, const QPixmap &pixmap)>;
+
+    explicit Prerasterizer(Sink sink, QObject *parent = nullptr);
+    ~Prerasterizer() override;
+
+    void start(const std::vector<Job> &jobs);
+    std::size_t delivered() const;
+
+    // Called from the pool threads
+    void finish(std::uint64_t key, QImage image);
+
+private:
+    struct Result {
+        std::uint64_t key;
+        QImage image;
+    };
+
+    void drain();
+
+    Sink m_sink;
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    std::vector<Result> m_results;
+    bool m_drainScheduled = false;
+    std::size_t m_delivered = 0;
+};
+
+} // namespace CSD::Internal
@@ -0,0 +1,172 @@
+#include "csdprogressstrip.h"
+
+#include <QFutureWatcher>
+#include <QPainter>
+#include <QTimerEvent>
+
+#include <algorithm>
+#include <cmath>
+
+namespace CSD::Internal {
+
+ProgressStrip::ProgressStrip(QWidget *parent, int frequency)
+    : QWidget(parent), m_interval(1000 / std::max(frequency, 1)) {
+    this->setAttribute(Qt::WA_TransparentForMouseEvents);
+    this->setAttribute(Qt::WA_NoSystemBackground);
+    this->hide();
+}
+
+void ProgressStrip::watch(const QFuture<void> &future) {
+    if (future.isFinished() || this->isWatching(future)) {
+        return;
+    }
+    auto *watcher = new QFutureWatcher<void>(this);
+    QObject::connect(watcher,
+                     &QFutureWatcherBase::progressValueChanged,
+                     this,
+                     &ProgressStrip::markDirty);
+    QObject::connect(watcher,
+                     &QFutureWatcherBase::progressRangeChanged,
+                     this,
+                     &ProgressStrip::markDirty);
+    QObject::connect(watcher,
+                     &QFutureWatcherBase::finished,
+                     this,
+                     [this, watcher]() { this->removeWatcher(watcher); });
+    watcher->setFuture(future);
+    this->m_watchers.push_back(watcher);
+    this->raise();
+    this->show();
+    this->markDirty();
+}
+
+bool ProgressStrip::isWatching(const QFuture<void> &future) const {
+    return std::any_of(std::begin(this->m_watchers),
+                       std::end(this->m_watchers),
+                       [&future](const QFutureWatcher<void> *watcher) {
+                           return watcher->future() == future;
+                       });
+}
+
+int ProgressStrip::frequency() const {
+    return 1000 / this->m_interval;
+}
+
+void ProgressStrip::setFrequency(int frequency) {
+    this->m_interval = 1000 / std::max(frequency, 1);
+    if (this->m_timer.isActive()) {
+        this->m_timer.start(this->m_interval, Qt::CoarseTimer, this);
+    }
+}
+
+QColor ProgressStrip::color() const {
+    return this->m_color;
+}
+
+void ProgressStrip::setColor(const QColor &color) {
+    this->m_color = color;
+    this->update();
+}
+
+std::size_t ProgressStrip::ticks() const {
+    return this->m_ticks;
+}
+
+std::size_t ProgressStrip::repaints() const {
+    return this->m_repaints;
+}
+
+void ProgressStrip::resetCounters() {
+    this->m_ticks = 0;
+    this->m_repaints = 0;
+}
+
+void ProgressStrip::paintEvent([[maybe_unused]] QPaintEvent *event) {
+    auto painter = QPainter(this);
+    const qreal devicePixelRatio = this->devicePixelRatioF();
+    painter.fillRect(QRectF(0.0,
+                            0.0,
+                            this->m_paintedWidth / devicePixelRatio,
+                            this->height()),
+                     this->m_color);
+}
+
+void ProgressStrip::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    this->m_paintedWidth = this->barWidth();
+}
+
+void ProgressStrip::timerEvent(QTimerEvent *event) {
+    if (event->timerId() != this->m_timer.timerId()) {
+        QWidget::timerEvent(event);
+        return;
+    }
+
+    if (!this->m_dirty) {
+        this->m_timer.stop();
+        return;
+    }
+    this->m_dirty = false;
+    ++this->m_ticks;
+
+    if (this->m_watchers.empty()) {
+        this->m_paintedWidth = 0;
+        this->m_timer.stop();
+        this->hide();
+        return;
+    }
+
+    const int width = this->barWidth();
+    if (width == this->m_paintedWidth) {
+        return;
+    }
+
+    // Only the part of the strip between the old and the new end changes
+    const qreal devicePixelRatio = this->devicePixelRatioF();
+    const int from = static_cast<int>(
+        std::floor(std::min(width, this->m_paintedWidth) / devicePixelRatio));
+    const int to = static_cast<int>(
+        std::ceil(std::max(width, this->m_paintedWidth) / devicePixelRatio));
+    this->m_paintedWidth = width;
+    this->update(QRect(from, 0, to - from, this->height()));
+    ++this->m_repaints;
+}
+
+void ProgressStrip::markDirty() {
+    this->m_dirty = true;
+    if (!this->m_timer.isActive()) {
+        this->m_timer.start(this->m_interval, Qt::CoarseTimer, this);
+    }
+}
+
+void ProgressStrip::removeWatcher(QFutureWatcher<void> *watcher) {
+    this->m_watchers.erase(std::remove(std::begin(this->m_watchers),
+                                       std::end(this->m_watchers),
+                                       watcher),
+                           std::end(this->m_watchers));
+    watcher->deleteLater();
+    this->markDirty();
+}
+
+double ProgressStrip::fraction() const {
+    if (this->m_watchers.empty()) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (const QFutureWatcher<void> *watcher : this->m_watchers) {
+        const int minimum = watcher->progressMinimum();
+        const int maximum = watcher->progressMaximum();
+        if (maximum > minimum) {
+            sum += static_cast<double>(watcher->progressValue() - minimum) /
+                   static_cast<double>(maximum - minimum);
+        }
+    }
+    return sum / static_cast<double>(this->m_watchers.size());
+}
+
+int ProgressStrip::barWidth() const {
+    return static_cast<int>(std::lround(
+        this->fraction() * this->width() * this->devicePixelRatioF()));
+}
+
+} // namespace CSD::Internal
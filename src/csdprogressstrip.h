@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QBasicTimer>
+#include <QColor>
+#include <QFuture>
+#include <QWidget>
+
+#include <cstddef>
+#include <vector>
+
+template <typename T>
+class QFutureWatcher;
+
+namespace CSD::Internal {
+
+// Thin bar showing the combined progress of all watched futures. Progress
+// notifications only mark the bar dirty; it is repainted at most frequency()
+// times per second, only within its own rect, and only if its length changed
+// by at least one device pixel. The bar hides itself while nothing runs.
+class ProgressStrip : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit ProgressStrip(QWidget *parent = nullptr, int frequency = 30);
+    ~ProgressStrip() override = default;
+
+    void watch(const QFuture<void> &future);
+    bool isWatching(const QFuture<void> &future) const;
+    int frequency() const;
+    void setFrequency(int frequency);
+    QColor color() const;
+    void setColor(const QColor &color);
+
+    std::size_t ticks() const;
+    std::size_t repaints() const;
+    void resetCounters();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    void markDirty();
+    void removeWatcher(QFutureWatcher<void> *watcher);
+    double fraction() const;
+    int barWidth() const;
+
+    std::vector<QFutureWatcher<void> *> m_watchers;
+    QColor m_color = QColor(97, 175, 239);
+    QBasicTimer m_timer;
+    int m_interval;
+    int m_paintedWidth = 0;
+    bool m_dirty = false;
+    std::size_t m_ticks = 0;
+    std::size_t m_repaints = 0;
+};
+
+} // namespace CSD::Internal
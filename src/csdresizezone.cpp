@@ -0,0 +1,55 @@
+#include "csdresizezone.h"
+
+namespace CSD::Internal {
+
+ResizeZone resizeZoneAt(const QRect &bounds,
+                        const QPoint &pos,
+                        int borderWidth,
+                        bool resizeWidth,
+                        bool resizeHeight) {
+    if (!bounds.contains(pos)) {
+        return ResizeZone::None;
+    }
+
+    const int left = bounds.x();
+    const int top = bounds.y();
+    const int right = bounds.x() + bounds.width();
+    const int bottom = bounds.y() + bounds.height();
+
+    const bool onLeft =
+        resizeWidth && pos.x() >= left && pos.x() < left + borderWidth;
+    const bool onRight =
+        resizeWidth && pos.x() < right && pos.x() >= right - borderWidth;
+    const bool onTop =
+        resizeHeight && pos.y() >= top && pos.y() < top + borderWidth;
+    const bool onBottom =
+        resizeHeight && pos.y() < bottom && pos.y() >= bottom - borderWidth;
+
+    if (onTop && onLeft) {
+        return ResizeZone::TopLeft;
+    }
+    if (onTop && onRight) {
+        return ResizeZone::TopRight;
+    }
+    if (onBottom && onLeft) {
+        return ResizeZone::BottomLeft;
+    }
+    if (onBottom && onRight) {
+        return ResizeZone::BottomRight;
+    }
+    if (onTop) {
+        return ResizeZone::Top;
+    }
+    if (onBottom) {
+        return ResizeZone::Bottom;
+    }
+    if (onLeft) {
+        return ResizeZone::Left;
+    }
+    if (onRight) {
+        return ResizeZone::Right;
+    }
+    return ResizeZone::None;
+}
+
+} // namespace CSD::Internal
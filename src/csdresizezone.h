@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QPoint>
+#include <QRect>
+
+#include <cstdint>
+
+namespace CSD::Internal {
+
+enum class ResizeZone : std::uint8_t {
+    None,
+    Left,
+    Right,
+    Top,
+    Bottom,
+    TopLeft,
+    TopRight,
+    BottomLeft,
+    BottomRight
+};
+
+// Resize zone of pos within a frameless window occupying bounds. Edges are
+// borderWidth wide; corners are only reported if the window can be resized
+// in both directions. This is shared by the Win32 WM_NCHITTEST handler and
+// the Linux filter and does not touch any window system API.
+ResizeZone resizeZoneAt(const QRect &bounds,
+                        const QPoint &pos,
+                        int borderWidth,
+                        bool resizeWidth,
+                        bool resizeHeight);
+
+} // namespace CSD::Internal
@@ -0,0 +1,64 @@
+#include "csdstyleresources.h"
+
+#include <QDir>
+#include <QResource>
+#include <QtGlobal>
+
+#include <utility>
+
+namespace CSD::Internal {
+
+// The custom and win glyphs are drawn by CaptionGlyphEngine and need no
+// bundle
+static QString bundleName(CaptionButtonStyle style) {
+    switch (style) {
+    case CaptionButtonStyle::custom:
+    case CaptionButtonStyle::win: {
+        break;
+    }
+    case CaptionButtonStyle::mac: {
+        return QStringLiteral("csd-mac.rcc");
+    }
+    }
+    return QString();
+}
+
+StyleResources::StyleResources(QString directory)
+    : m_directory(std::move(directory)) {}
+
+StyleResources::~StyleResources() {
+    if (!this->m_registeredBundle.isEmpty()) {
+        QResource::unregisterResource(this->m_registeredBundle);
+    }
+}
+
+bool StyleResources::activate(CaptionButtonStyle style) {
+    const QString name = bundleName(style);
+    if (name.isEmpty()) {
+        if (!this->m_registeredBundle.isEmpty()) {
+            QResource::unregisterResource(this->m_registeredBundle);
+            this->m_registeredBundle.clear();
+        }
+        return true;
+    }
+
+    const QString bundle = QDir(this->m_directory).filePath(name);
+    if (bundle == this->m_registeredBundle) {
+        return true;
+    }
+
+    // The old bundle is only dropped once the new one is in place, so a
+    // missing file leaves the previous style working
+    if (!QResource::registerResource(bundle)) {
+        qWarning("CSD: could not register caption glyphs from %s",
+                 qPrintable(QDir::toNativeSeparators(bundle)));
+        return false;
+    }
+    if (!this->m_registeredBundle.isEmpty()) {
+        QResource::unregisterResource(this->m_registeredBundle);
+    }
+    this->m_registeredBundle = bundle;
+    return true;
+}
+
+} // namespace CSD::Internal
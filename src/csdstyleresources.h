@@ -0,0 +1,28 @@
+#pragma once
+
+#include "captionbuttonstyle.h"
+
+#include <QString>
+
+namespace CSD::Internal {
+
+// Keeps the binary resource bundle with the caption glyphs of the selected
+// style registered. The bundles are the csd-<style>.rcc files built next to
+// the plugin; QResource maps them, so styles that are not selected cost
+// neither load time nor memory. Styles whose glyphs are drawn have none.
+class StyleResources {
+public:
+    explicit StyleResources(QString directory);
+    ~StyleResources();
+
+    StyleResources(const StyleResources &) = delete;
+    StyleResources &operator=(const StyleResources &) = delete;
+
+    bool activate(CaptionButtonStyle style);
+
+private:
+    QString m_directory;
+    QString m_registeredBundle;
+};
+
+} // namespace CSD::Internal
@@ -0,0 +1,189 @@
+#include "csdtint.h"
+
+#include <QtGlobal>
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSD_TINT_SSE2
+#include <emmintrin.h>
+#endif
+// GCC and Clang build the AVX2 row for any target and pick it at runtime,
+// MSVC only has it when the whole plugin is built for AVX2
+#if defined(__GNUC__)
+#define CSD_TINT_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define CSD_TINT_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace CSD::Internal {
+
+// Rounds value / 255 for value in [0, 255 * 255] without a division
+static inline std::uint32_t div255(std::uint32_t value) {
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+static void tintRowScalar(const std::uint8_t *mask,
+                          std::uint32_t *out,
+                          int count,
+                          std::uint32_t color) {
+    for (int x = 0; x < count; ++x) {
+        const std::uint32_t alpha = mask[x];
+        std::uint32_t pixel = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            pixel |= div255(((color >> shift) & 0xFF) * alpha) << shift;
+        }
+        out[x] = pixel;
+    }
+}
+
+#ifdef CSD_TINT_SSE2
+// Multiplies the color, repeated as 16 bit channels, by the mask values in
+// alpha and divides by 255 like div255
+static inline __m128i tintChannels(__m128i alpha, __m128i color) {
+    const __m128i product =
+        _mm_add_epi16(_mm_mullo_epi16(alpha, color), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)),
+                          8);
+}
+
+static void tintRowSse2(const std::uint8_t *mask,
+                        std::uint32_t *out,
+                        int count,
+                        std::uint32_t color) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i channels = _mm_unpacklo_epi8(
+        _mm_cvtsi32_si128(static_cast<int>(color)), zero);
+    const __m128i colors = _mm_unpacklo_epi64(channels, channels);
+
+    // Eight pixels per iteration: the mask values are widened to 16 bits and
+    // each one is spread over the four channels of its pixel
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        const __m128i alpha = _mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i *>(mask + x)),
+            zero);
+        const __m128i low = _mm_unpacklo_epi16(alpha, alpha);
+        const __m128i high = _mm_unpackhi_epi16(alpha, alpha);
+        const __m128i pixels0 =
+            tintChannels(_mm_unpacklo_epi32(low, low), colors);
+        const __m128i pixels1 =
+            tintChannels(_mm_unpackhi_epi32(low, low), colors);
+        const __m128i pixels2 =
+            tintChannels(_mm_unpacklo_epi32(high, high), colors);
+        const __m128i pixels3 =
+            tintChannels(_mm_unpackhi_epi32(high, high), colors);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x),
+                         _mm_packus_epi16(pixels0, pixels1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x + 4),
+                         _mm_packus_epi16(pixels2, pixels3));
+    }
+    tintRowScalar(mask + x, out + x, count - x, color);
+}
+#endif
+
+#ifdef CSD_TINT_AVX2
+CSD_TINT_AVX2 static inline __m256i tintChannels(__m256i alpha,
+                                                  __m256i color) {
+    const __m256i product = _mm256_add_epi16(_mm256_mullo_epi16(alpha, color),
+                                             _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(
+        _mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+CSD_TINT_AVX2 static void tintRowAvx2(const std::uint8_t *mask,
+                                      std::uint32_t *out,
+                                      int count,
+                                      std::uint32_t color) {
+    const __m256i colors =
+        _mm256_cvtepu8_epi16(_mm_set1_epi32(static_cast<int>(color)));
+
+    // Sixteen pixels per iteration. The unpacks work within 128 bit lanes,
+    // so the packed halves hold pixels 0-3 and 8-11, and 4-7 and 12-15
+    // until the lanes are swapped back into order.
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const __m256i alpha = _mm256_cvtepu8_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + x)));
+        const __m256i low = _mm256_unpacklo_epi16(alpha, alpha);
+        const __m256i high = _mm256_unpackhi_epi16(alpha, alpha);
+        const __m256i pixels0 =
+            tintChannels(_mm256_unpacklo_epi32(low, low), colors);
+        const __m256i pixels1 =
+            tintChannels(_mm256_unpackhi_epi32(low, low), colors);
+        const __m256i pixels2 =
+            tintChannels(_mm256_unpacklo_epi32(high, high), colors);
+        const __m256i pixels3 =
+            tintChannels(_mm256_unpackhi_epi32(high, high), colors);
+        const __m256i packed0 = _mm256_packus_epi16(pixels0, pixels1);
+        const __m256i packed1 = _mm256_packus_epi16(pixels2, pixels3);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x),
+                            _mm256_permute2x128_si256(packed0, packed1, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x + 8),
+                            _mm256_permute2x128_si256(packed0, packed1, 0x31));
+    }
+    tintRowScalar(mask + x, out + x, count - x, color);
+}
+#endif
+
+TintRow tintRow(TintKernel kernel) {
+    switch (kernel) {
+    case TintKernel::Scalar: {
+        return tintRowScalar;
+    }
+    case TintKernel::Sse2: {
+#ifdef CSD_TINT_SSE2
+        return tintRowSse2;
+#else
+        return nullptr;
+#endif
+    }
+    case TintKernel::Avx2: {
+#if defined(CSD_TINT_AVX2) && defined(__GNUC__)
+        return __builtin_cpu_supports("avx2") ? tintRowAvx2 : nullptr;
+#elif defined(CSD_TINT_AVX2)
+        return tintRowAvx2;
+#else
+        return nullptr;
+#endif
+    }
+    }
+    return nullptr;
+}
+
+static TintRow selectTintRow() {
+    for (const TintKernel kernel : {TintKernel::Avx2, TintKernel::Sse2}) {
+        const TintRow row = tintRow(kernel);
+        if (row != nullptr) {
+            return row;
+        }
+    }
+    return tintRowScalar;
+}
+
+QImage tintMask(const QImage &mask, QRgb color) {
+    const QImage alpha = mask.format() == QImage::Format_Alpha8
+                             ? mask
+                             : mask.convertToFormat(QImage::Format_Alpha8);
+    auto image = QImage(alpha.size(), QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(alpha.devicePixelRatio());
+
+    static const TintRow row = selectTintRow();
+    const std::uint32_t premultiplied = qPremultiply(color);
+    for (int y = 0; y < alpha.height(); ++y) {
+        row(alpha.constScanLine(y),
+                reinterpret_cast<std::uint32_t *>(image.scanLine(y)),
+                alpha.width(),
+                premultiplied);
+    }
+    return image;
+}
+
+} // namespace CSD::Internal
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QImage>
+#include <QRgb>
+
+#include <cstdint>
+
+namespace CSD::Internal {
+
+// Colors an alpha mask: every pixel of the result is color scaled by the mask
+// value, as premultiplied ARGB32. The rows are processed with AVX2 or SSE2
+// where the CPU has them and with plain integer math elsewhere; all paths
+// give identical results.
+QImage tintMask(const QImage &mask, QRgb color);
+
+// The row kernels behind tintMask, for tests comparing them. A row tints
+// count mask values with a premultiplied color.
+enum class TintKernel { Scalar, Sse2, Avx2 };
+using TintRow = void (*)(const std::uint8_t *mask,
+                         std::uint32_t *out,
+                         int count,
+                         std::uint32_t color);
+// Null if the kernel is not built for this target or the CPU lacks it
+TintRow tintRow(TintKernel kernel);
+
+} // namespace CSD::Internal
@@ -1,11 +1,17 @@
 #include "csdtitlebar.h"
 
+#include "captionicons.h"
+#include "csdactionbinding.h"
+#include "csdfadeanimator.h"
+#include "csdprogressstrip.h"
 #include "csdtitlebarbutton.h"
 
 #include <coreplugin/actionmanager/actionmanager.h>
 #include <coreplugin/coreconstants.h>
 #include <coreplugin/designmode.h>
 #include <coreplugin/modemanager.h>
+#include <coreplugin/progressmanager/futureprogress.h>
+#include <coreplugin/progressmanager/progressmanager.h>
 #include <debugger/debuggerconstants.h>
 #include <help/helpconstants.h>
 #include <projectexplorer/buildmanager.h>
@@ -29,12 +35,19 @@
 #include <QEvent>
 #include <QMainWindow>
 #include <QMenuBar>
+#include <QMouseEvent>
+#include <QPaintEvent>
 #include <QPainter>
 #include <QStyleOption>
 #include <QTimer>
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #if !defined(_WIN32) && !defined(__APPLE__)
-#include <QMouseEvent>
+#include "x11moveresize.h"
+
 #include <QWindow>
 
 #include <QX11Info>
@@ -42,15 +55,14 @@
 #include <private/qhighdpiscaling_p.h>
 #include <qpa/qplatformscreen.h>
 #include <qpa/qplatformwindow.h>
-
-#include <cstring>
 #endif
 
 namespace CSD {
 
-#if !defined(_WIN32) && !defined(__APPLE__)
-constexpr static const char _NET_WM_MOVERESIZE[] = "_NET_WM_MOVERESIZE";
+constexpr static int progressStripHeight = 2;
+constexpr static std::size_t toolIconPrerenderBatchSize = 4;
 
+#if !defined(_WIN32) && !defined(__APPLE__)
 static QWidget *titleBarTopLevelWidget(QWidget *w) {
     while (w && !w->isWindow() && w->windowType() != Qt::SubWindow) {
         w = w->parentWidget();
@@ -59,10 +71,33 @@ static QWidget *titleBarTopLevelWidget(QWidget *w) {
 }
 #endif
 
+static int captionButtonWidth(CaptionButtonStyle style) {
+    switch (style) {
+    case CaptionButtonStyle::custom: {
+        return 30;
+    }
+    case CaptionButtonStyle::win: {
+        return 46;
+    }
+    case CaptionButtonStyle::mac: {
+        return 26;
+    }
+    }
+    return 30;
+}
+
+static QSize captionButtonIconSize(CaptionButtonStyle style) {
+    return style == CaptionButtonStyle::mac ? QSize(16, 16) : QSize(12, 12);
+}
+
 TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
                    const QIcon &captionIcon,
-                   QWidget *parent)
-    : QWidget(parent), m_captionButtonStyle(captionButtonStyle) {
+                   QWidget *parent,
+                   Controls controls,
+                   Rendering rendering)
+    : QWidget(parent),
+      m_visualState(captionButtonStyle, false, false, false),
+      m_rendering(rendering) {
     this->setObjectName("TitleBar");
     this->setMinimumSize(QSize(0, 30));
     this->setMaximumSize(QSize(QWIDGETSIZE_MAX, 30));
@@ -76,30 +111,29 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
 #endif
     }();
 
+    this->m_fadeAnimator = new Internal::FadeAnimator(this);
+
     this->m_horizontalLayout = new QHBoxLayout(this);
     this->m_horizontalLayout->setSpacing(0);
     this->m_horizontalLayout->setObjectName("HorizontalLayout");
     this->m_horizontalLayout->setContentsMargins(0, 0, 0, 0);
 
-    this->m_leftMargin = new QWidget(this);
-    this->m_leftMargin->setObjectName("LeftMargin");
-    this->m_leftMargin->setMinimumSize(QSize(5, 0));
-    this->m_leftMargin->setMaximumSize(QSize(5, QWIDGETSIZE_MAX));
-    this->m_horizontalLayout->addWidget(this->m_leftMargin);
-
-    this->m_buttonCaptionIcon =
-        new TitleBarButton(TitleBarButton::CaptionIcon, this);
-    this->m_buttonCaptionIcon->setObjectName("ButtonCaptionIcon");
-    this->m_buttonCaptionIcon->setMinimumSize(QSize(30, 30));
-    this->m_buttonCaptionIcon->setMaximumSize(QSize(30, 30));
-    this->m_buttonCaptionIcon->setFocusPolicy(Qt::NoFocus);
+    // The left margin, the caption icon and the empty space are not
+    // interactive, so they are plain layout items instead of child widgets;
+    // the caption icon is painted by paintEvent
+    this->m_leftMargin =
+        new QSpacerItem(5, 0, QSizePolicy::Fixed, QSizePolicy::Minimum);
+    this->m_horizontalLayout->addItem(this->m_leftMargin);
+
+    this->m_captionIconItem =
+        new QSpacerItem(30, 30, QSizePolicy::Fixed, QSizePolicy::Fixed);
 #ifdef _WIN32
     int icon_size = ::GetSystemMetrics(SM_CXSMICON);
 #else
     int icon_size = 16;
 #endif
-    this->m_buttonCaptionIcon->setIconSize(QSize(icon_size, icon_size));
-    const auto icon = [&captionIcon, this]() -> QIcon {
+    this->m_captionIconSize = QSize(icon_size, icon_size);
+    this->m_captionIcon = [&captionIcon, this]() -> QIcon {
         if (!captionIcon.isNull()) {
             return captionIcon;
         }
@@ -113,9 +147,8 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
         }
 #ifdef _WIN32
         // Use system default application icon which doesn't need margin
-        this->m_horizontalLayout->takeAt(
-            this->m_horizontalLayout->indexOf(this->m_leftMargin));
-        this->m_leftMargin->setParent(nullptr);
+        this->m_leftMargin->changeSize(
+            0, 0, QSizePolicy::Fixed, QSizePolicy::Minimum);
         HICON winIcon = ::LoadIconW(nullptr, IDI_APPLICATION);
         globalWindowIcon.addPixmap(
             QtWinBackports::qt_pixmapFromWinHICON(winIcon));
@@ -128,8 +161,7 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
 #endif
         return globalWindowIcon;
     }();
-    this->m_buttonCaptionIcon->setIcon(icon);
-    this->m_horizontalLayout->addWidget(this->m_buttonCaptionIcon);
+    this->m_horizontalLayout->addItem(this->m_captionIconItem);
 
     auto *mainWindow = qobject_cast<QMainWindow *>(this->window());
     if (mainWindow != nullptr) {
@@ -138,97 +170,216 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
         this->m_menuBar->setFixedHeight(30);
     }
 
-    auto *emptySpace = new QWidget(this);
-    emptySpace->setAttribute(Qt::WA_TransparentForMouseEvents);
-    this->m_horizontalLayout->addWidget(emptySpace, 1);
+    this->m_horizontalLayout->addStretch(1);
 
-    Core::Command *commandRun =
-        Core::ActionManager::command("ProjectExplorer.Run");
+    this->m_toolButtonsIndex = this->m_horizontalLayout->count();
+
+    const int captionButtonsWidth =
+        captionButtonWidth(this->m_visualState.style());
+    if (this->m_rendering == Rendering::Flyweight) {
+        this->createFlyweightButtons(captionButtonsWidth);
+    } else {
+        this->createCaptionButtons(
+            captionButtonsWidth,
+            captionButtonIconSize(this->m_visualState.style()));
+    }
+
+    if (controls == Controls::All) {
+        this->createToolButtons();
+    }
+
+    this->m_visualState =
+        this->m_visualState.withActive(this->window()->isActiveWindow())
+            .withMaximized(static_cast<bool>(this->window()->windowState() &
+                                             Qt::WindowMaximized));
+    this->updateBackground();
+    this->prerasterizeCaptionIcons(this->m_visualState.style());
+}
 
-    auto onModeBarRunActionChanged = [commandRun, this] {
-        this->m_buttonRun->setEnabled(commandRun->action()->isEnabled());
-        this->m_buttonRun->setIcon(commandRun->action()->icon());
-        this->m_buttonRun->disconnect(SIGNAL(clicked()));
-        QObject::connect(this->m_buttonRun,
-                         &QPushButton::clicked,
-                         commandRun->action(),
-                         &QAction::trigger);
+#ifdef _WIN32
+std::optional<QColor> TitleBar::readDWMColorizationColor() {
+    auto handleKey = ::HKEY();
+    auto regOpenResult = ::RegOpenKeyExW(HKEY_CURRENT_USER,
+                                         L"SOFTWARE\\Microsoft\\Windows\\DWM",
+                                         0,
+                                         KEY_READ,
+                                         &handleKey);
+    if (regOpenResult != ERROR_SUCCESS) {
+        return std::nullopt;
+    }
+    auto value = ::DWORD();
+    auto dwordBufferSize = ::DWORD(sizeof(::DWORD));
+    auto regQueryResult = ::RegQueryValueExW(handleKey,
+                                             L"ColorizationColor",
+                                             nullptr,
+                                             nullptr,
+                                             reinterpret_cast<LPBYTE>(&value),
+                                             &dwordBufferSize);
+    if (regQueryResult != ERROR_SUCCESS) {
+        return std::nullopt;
+    }
+    return QColor(static_cast<QRgb>(value));
+}
+#endif
+
+void TitleBar::createCaptionButtons(int width, const QSize &iconSize) {
+    this->m_buttonMinimize =
+        new TitleBarButton(TitleBarButton::Minimize, this);
+    this->m_buttonMinimize->setObjectName("ButtonMinimize");
+    this->m_buttonMinimize->setMinimumSize(QSize(width, 30));
+    this->m_buttonMinimize->setMaximumSize(QSize(width, 30));
+    this->m_buttonMinimize->setFocusPolicy(Qt::NoFocus);
+    this->m_buttonMinimize->setIconSize(iconSize);
+    this->m_horizontalLayout->addWidget(this->m_buttonMinimize);
+    connect(this->m_buttonMinimize, &QPushButton::clicked, this, [this]() {
+        emit this->minimizeClicked();
+    });
+
+    this->m_buttonMaximizeRestore =
+        new TitleBarButton(TitleBarButton::MaximizeRestore, this);
+    this->m_buttonMaximizeRestore->setObjectName("ButtonMaximizeRestore");
+    this->m_buttonMaximizeRestore->setMinimumSize(QSize(width, 30));
+    this->m_buttonMaximizeRestore->setMaximumSize(QSize(width, 30));
+    this->m_buttonMaximizeRestore->setFocusPolicy(Qt::NoFocus);
+    this->m_buttonMaximizeRestore->setIconSize(iconSize);
+    this->m_horizontalLayout->addWidget(this->m_buttonMaximizeRestore);
+    connect(this->m_buttonMaximizeRestore,
+            &QPushButton::clicked,
+            this,
+            [this]() { emit this->maximizeRestoreClicked(); });
+
+    this->m_buttonClose = new TitleBarButton(TitleBarButton::Close, this);
+    this->m_buttonClose->setObjectName("ButtonClose");
+    this->m_buttonClose->setMinimumSize(QSize(width, 30));
+    this->m_buttonClose->setMaximumSize(QSize(width, 30));
+    this->m_buttonClose->setFocusPolicy(Qt::NoFocus);
+    this->m_buttonClose->setIconSize(iconSize);
+    this->m_horizontalLayout->addWidget(this->m_buttonClose);
+    connect(this->m_buttonClose, &QPushButton::clicked, this, [this]() {
+        emit this->closeClicked();
+    });
+}
+
+void TitleBar::createFlyweightButtons(int width) {
+    // The title bar tracks hover itself, so it needs mouse moves without a
+    // button pressed
+    this->setMouseTracking(true);
+    constexpr auto roles = std::array<TitleBarButton::Role, 3>{
+        TitleBarButton::Minimize,
+        TitleBarButton::MaximizeRestore,
+        TitleBarButton::Close};
+    for (std::size_t i = 0; i < roles.size(); ++i) {
+        FlyweightButton &button = this->m_flyweightButtons[i];
+        button.role = roles[i];
+        button.item = new QSpacerItem(
+            width, 30, QSizePolicy::Fixed, QSizePolicy::Fixed);
+        button.fadeSlot = this->m_fadeAnimator->add(button.item);
+        this->m_horizontalLayout->addItem(button.item);
+    }
+}
+
+void TitleBar::createToolButtons() {
+    if (this->m_buttonRun != nullptr) {
+        return;
+    }
+
+    // Tool and mode buttons go between the empty space and the caption
+    // buttons, even if the title bar is already laid out
+    int toolButtonIndex = this->m_toolButtonsIndex;
+
+    auto setToolButtonIconOf = [this](TitleBarButton *button) {
+        return [button, this](const QIcon &icon) {
+            this->setToolButtonIcon(button, icon);
+        };
     };
 
+    Core::Command *commandRun =
+        Core::ActionManager::command("ProjectExplorer.Run");
+
     this->m_buttonRun = new TitleBarButton(TitleBarButton::Tool, this);
     this->m_buttonRun->setMinimumSize(QSize(30, 30));
     this->m_buttonRun->setMaximumSize(QSize(30, 30));
-    QObject::connect(commandRun->action(),
-                     &QAction::changed,
-                     this->m_buttonRun,
-                     onModeBarRunActionChanged);
-    this->m_horizontalLayout->addWidget(m_buttonRun);
+    this->m_bindingRun = new Internal::ActionBinding(
+        this->m_buttonRun,
+        [commandRun]() -> Internal::ActionBinding::Target {
+            return {commandRun->action(), commandRun->action()->icon()};
+        },
+        setToolButtonIconOf(this->m_buttonRun));
+    this->m_bindingRun->watch(commandRun->action());
+    this->m_bindingRun->update();
+    this->m_horizontalLayout->insertWidget(toolButtonIndex++,
+                                           this->m_buttonRun);
 
     Core::Command *commandDebug =
         Core::ActionManager::command("Debugger.Debug");
 
-    auto onModeBarDebugActionChanged = [commandDebug, this] {
-        this->m_buttonDebug->setEnabled(commandDebug->action()->isEnabled());
-        this->m_buttonDebug->setIcon(commandDebug->action()->icon());
-        this->m_buttonDebug->disconnect(SIGNAL(clicked()));
-        QObject::connect(this->m_buttonDebug,
-                         &QPushButton::clicked,
-                         commandDebug->action(),
-                         &QAction::trigger);
-    };
-
     this->m_buttonDebug = new TitleBarButton(TitleBarButton::Tool, this);
     this->m_buttonDebug->setMinimumSize(QSize(30, 30));
     this->m_buttonDebug->setMaximumSize(QSize(30, 30));
-    QObject::connect(commandDebug->action(),
-                     &QAction::changed,
-                     this->m_buttonDebug,
-                     onModeBarDebugActionChanged);
-    this->m_horizontalLayout->addWidget(m_buttonDebug);
+    this->m_bindingDebug = new Internal::ActionBinding(
+        this->m_buttonDebug,
+        [commandDebug]() -> Internal::ActionBinding::Target {
+            return {commandDebug->action(), commandDebug->action()->icon()};
+        },
+        setToolButtonIconOf(this->m_buttonDebug));
+    this->m_bindingDebug->watch(commandDebug->action());
+    this->m_bindingDebug->update();
+    this->m_horizontalLayout->insertWidget(toolButtonIndex++,
+                                           this->m_buttonDebug);
 
     Core::Command *commandBuild =
         Core::ActionManager::command(ProjectExplorer::Constants::BUILD);
     Core::Command *commandCancelBuild =
         Core::ActionManager::command("ProjectExplorer.CancelBuild");
 
-    auto onModeBarBuildActionChanged =
-        [commandBuild, commandCancelBuild, this] {
-            if (ProjectExplorer::BuildManager::isBuilding(
-                    ProjectExplorer::SessionManager::startupProject())) {
-                this->m_buttonBuild->setEnabled(
-                    commandCancelBuild->action()->isEnabled());
-                this->m_buttonBuild->setIcon(
-                    ProjectExplorer::Icons::CANCELBUILD_FLAT.icon());
-                this->m_buttonBuild->disconnect(SIGNAL(clicked()));
-                QObject::connect(this->m_buttonBuild,
-                                 &QPushButton::clicked,
-                                 commandCancelBuild->action(),
-                                 &QAction::trigger);
-            } else {
-                this->m_buttonBuild->setEnabled(
-                    commandBuild->action()->isEnabled());
-                this->m_buttonBuild->setIcon(commandBuild->action()->icon());
-                this->m_buttonBuild->disconnect(SIGNAL(clicked()));
-                QObject::connect(this->m_buttonBuild,
-                                 &QPushButton::clicked,
-                                 commandBuild->action(),
-                                 &QAction::trigger);
-            }
-        };
-
     this->m_buttonBuild = new TitleBarButton(TitleBarButton::Tool, this);
     this->m_buttonBuild->setMinimumSize(QSize(30, 30));
     this->m_buttonBuild->setMaximumSize(QSize(30, 30));
-    this->m_buttonBuild->setIcon(commandBuild->action()->icon());
-    QObject::connect(commandBuild->action(),
-                     &QAction::changed,
-                     this->m_buttonBuild,
-                     onModeBarBuildActionChanged);
-    QObject::connect(commandCancelBuild->action(),
-                     &QAction::changed,
-                     this->m_buttonBuild,
-                     onModeBarBuildActionChanged);
-    this->m_horizontalLayout->addWidget(m_buttonBuild);
+    this->m_bindingBuild = new Internal::ActionBinding(
+        this->m_buttonBuild,
+        [commandBuild,
+         commandCancelBuild,
+         cancelBuildIcon = ProjectExplorer::Icons::CANCELBUILD_FLAT.icon(),
+         this]() -> Internal::ActionBinding::Target {
+            if (this->m_startupProjectBuilding) {
+                return {commandCancelBuild->action(), cancelBuildIcon};
+            }
+            return {commandBuild->action(), commandBuild->action()->icon()};
+        },
+        setToolButtonIconOf(this->m_buttonBuild));
+    this->m_bindingBuild->watch(commandBuild->action());
+    this->m_bindingBuild->watch(commandCancelBuild->action());
+
+    // Whether the startup project is building only changes when a build
+    // starts or finishes or the startup project changes, so it is tracked
+    // from those signals instead of queried on every action change
+    this->m_startupProjectBuilding = ProjectExplorer::BuildManager::isBuilding(
+        ProjectExplorer::SessionManager::startupProject());
+    QObject::connect(
+        ProjectExplorer::BuildManager::instance(),
+        &ProjectExplorer::BuildManager::buildStateChanged,
+        this,
+        [this](ProjectExplorer::Project *project) {
+            if (project == ProjectExplorer::SessionManager::startupProject()) {
+                this->setStartupProjectBuilding(
+                    ProjectExplorer::BuildManager::isBuilding(project));
+            }
+        });
+    QObject::connect(ProjectExplorer::BuildManager::instance(),
+                     &ProjectExplorer::BuildManager::buildQueueFinished,
+                     this,
+                     [this]() { this->setStartupProjectBuilding(false); });
+    QObject::connect(
+        ProjectExplorer::SessionManager::instance(),
+        &ProjectExplorer::SessionManager::startupProjectChanged,
+        this,
+        [this](ProjectExplorer::Project *project) {
+            this->setStartupProjectBuilding(
+                ProjectExplorer::BuildManager::isBuilding(project));
+        });
+    this->m_bindingBuild->update();
+    this->m_horizontalLayout->insertWidget(toolButtonIndex++,
+                                           this->m_buttonBuild);
 
     this->m_buttonModeWelcome = new TitleBarButton(TitleBarButton::Tool, this);
     this->m_buttonModeWelcome->setObjectName("ButtonModeWelcome");
@@ -246,7 +397,8 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
                          Core::ModeManager::instance()->activateMode(
                              Core::Constants::MODE_WELCOME);
                      });
-    this->m_horizontalLayout->addWidget(this->m_buttonModeWelcome);
+    this->m_horizontalLayout->insertWidget(toolButtonIndex++,
+                                           this->m_buttonModeWelcome);
 
     this->m_buttonModeEdit = new TitleBarButton(TitleBarButton::Tool, this);
     this->m_buttonModeEdit->setObjectName("ButtonModeEdit");
@@ -264,7 +416,8 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
                          Core::ModeManager::instance()->activateMode(
                              Core::Constants::MODE_EDIT);
                      });
-    this->m_horizontalLayout->addWidget(this->m_buttonModeEdit);
+    this->m_horizontalLayout->insertWidget(toolButtonIndex++,
+                                           this->m_buttonModeEdit);
 
     this->m_buttonModeDesign = new TitleBarButton(TitleBarButton::Tool, this);
     this->m_buttonModeDesign->setObjectName("ButtonModeDesign");
@@ -283,7 +436,8 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
                          Core::ModeManager::instance()->activateMode(
                              Core::Constants::MODE_DESIGN);
                      });
-    this->m_horizontalLayout->addWidget(this->m_buttonModeDesign);
+    this->m_horizontalLayout->insertWidget(toolButtonIndex++,
+                                           this->m_buttonModeDesign);
 
     this->m_buttonModeDebug = new TitleBarButton(TitleBarButton::Tool, this);
     this->m_buttonModeDebug->setObjectName("ButtonModeDebug");
@@ -301,7 +455,8 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
                          Core::ModeManager::instance()->activateMode(
                              Debugger::Constants::MODE_DEBUG);
                      });
-    this->m_horizontalLayout->addWidget(this->m_buttonModeDebug);
+    this->m_horizontalLayout->insertWidget(toolButtonIndex++,
+                                           this->m_buttonModeDebug);
 
     this->m_buttonModeProjects =
         new TitleBarButton(TitleBarButton::Tool, this);
@@ -321,7 +476,8 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
                          Core::ModeManager::instance()->activateMode(
                              ProjectExplorer::Constants::MODE_SESSION);
                      });
-    this->m_horizontalLayout->addWidget(this->m_buttonModeProjects);
+    this->m_horizontalLayout->insertWidget(toolButtonIndex++,
+                                           this->m_buttonModeProjects);
 
     this->m_buttonModeHelp = new TitleBarButton(TitleBarButton::Tool, this);
     this->m_buttonModeHelp->setObjectName("ButtonModeHelp");
@@ -340,7 +496,8 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
                          Core::ModeManager::instance()->activateMode(
                              Help::Constants::ID_MODE_HELP);
                      });
-    this->m_horizontalLayout->addWidget(this->m_buttonModeHelp);
+    this->m_horizontalLayout->insertWidget(toolButtonIndex++,
+                                           this->m_buttonModeHelp);
 
     QObject::connect(Core::ModeManager::instance(),
                      &Core::ModeManager::currentModeChanged,
@@ -388,97 +545,60 @@ TitleBar::TitleBar(CaptionButtonStyle captionButtonStyle,
                          });
     });
 
-    int captionButtonsWidth = 0;
-    switch (this->m_captionButtonStyle) {
-    case CaptionButtonStyle::custom: {
-        captionButtonsWidth = 30;
-        break;
-    }
-    case CaptionButtonStyle::win: {
-        captionButtonsWidth = 46;
-        break;
-    }
-    case CaptionButtonStyle::mac: {
-        captionButtonsWidth = 26;
-        break;
-    }
-    }
-
-    this->m_buttonMinimize =
-        new TitleBarButton(TitleBarButton::Minimize, this);
-    this->m_buttonMinimize->setObjectName("ButtonMinimize");
-    this->m_buttonMinimize->setMinimumSize(QSize(captionButtonsWidth, 30));
-    this->m_buttonMinimize->setMaximumSize(QSize(captionButtonsWidth, 30));
-    this->m_buttonMinimize->setFocusPolicy(Qt::NoFocus);
-    this->m_buttonMinimize->setIconSize(
-        this->m_captionButtonStyle == CaptionButtonStyle::mac ? QSize(16, 16)
-                                                              : QSize(12, 12));
-    this->m_horizontalLayout->addWidget(this->m_buttonMinimize);
-    connect(this->m_buttonMinimize, &QPushButton::clicked, this, [this]() {
-        emit this->minimizeClicked();
-    });
-
-    this->m_buttonMaximizeRestore =
-        new TitleBarButton(TitleBarButton::MaximizeRestore, this);
-    this->m_buttonMaximizeRestore->setObjectName("ButtonMaximizeRestore");
-    this->m_buttonMaximizeRestore->setMinimumSize(
-        QSize(captionButtonsWidth, 30));
-    this->m_buttonMaximizeRestore->setMaximumSize(
-        QSize(captionButtonsWidth, 30));
-    this->m_buttonMaximizeRestore->setFocusPolicy(Qt::NoFocus);
-    this->m_buttonMaximizeRestore->setIconSize(
-        this->m_captionButtonStyle == CaptionButtonStyle::mac ? QSize(16, 16)
-                                                              : QSize(12, 12));
-    this->m_horizontalLayout->addWidget(this->m_buttonMaximizeRestore);
-    connect(this->m_buttonMaximizeRestore,
-            &QPushButton::clicked,
-            this,
-            [this]() { emit this->maximizeRestoreClicked(); });
+    this->createProgressStrip();
 
-    this->m_buttonClose = new TitleBarButton(TitleBarButton::Close, this);
-    this->m_buttonClose->setObjectName("ButtonClose");
-    this->m_buttonClose->setMinimumSize(QSize(captionButtonsWidth, 30));
-    this->m_buttonClose->setMaximumSize(QSize(captionButtonsWidth, 30));
-    this->m_buttonClose->setFocusPolicy(Qt::NoFocus);
-    this->m_buttonClose->setIconSize(
-        this->m_captionButtonStyle == CaptionButtonStyle::mac ? QSize(16, 16)
-                                                              : QSize(12, 12));
-    this->m_horizontalLayout->addWidget(this->m_buttonClose);
-    connect(this->m_buttonClose, &QPushButton::clicked, this, [this]() {
-        emit this->closeClicked();
-    });
+    QTimer::singleShot(0, this, [this]() { this->prerenderToolIcons(0); });
+}
 
-    this->setAutoFillBackground(true);
-    this->setActive(this->window()->isActiveWindow());
-    this->setMaximized(static_cast<bool>(this->window()->windowState() &
-                                         Qt::WindowMaximized));
+void TitleBar::prerasterizeCaptionIcons(CaptionButtonStyle style) {
+    Internal::IconCache::instance().prerasterize(
+        style, captionButtonIconSize(style), this->devicePixelRatioF());
 }
 
-#ifdef _WIN32
-std::optional<QColor> TitleBar::readDWMColorizationColor() {
-    auto handleKey = ::HKEY();
-    auto regOpenResult = ::RegOpenKeyExW(HKEY_CURRENT_USER,
-                                         L"SOFTWARE\\Microsoft\\Windows\\DWM",
-                                         0,
-                                         KEY_READ,
-                                         &handleKey);
-    if (regOpenResult != ERROR_SUCCESS) {
-        return std::nullopt;
+void TitleBar::prerenderToolIcons(std::size_t next) {
+    // The shadowed tool icons are painted with QPainter on pixmaps, which
+    // only works on the GUI thread, so they are spread over a few event loop
+    // iterations instead. Normal icons are shown right away, active ones
+    // once a mode is switched and disabled ones least often.
+    const auto buttons = std::array<TitleBarButton *, 9>{
+        this->m_buttonRun,
+        this->m_buttonDebug,
+        this->m_buttonBuild,
+        this->m_buttonModeWelcome,
+        this->m_buttonModeEdit,
+        this->m_buttonModeDesign,
+        this->m_buttonModeDebug,
+        this->m_buttonModeProjects,
+        this->m_buttonModeHelp};
+    constexpr auto modes = std::array<QIcon::Mode, 3>{
+        QIcon::Normal, QIcon::Active, QIcon::Disabled};
+    const std::size_t count = buttons.size() * modes.size();
+
+    const std::size_t end =
+        std::min(next + toolIconPrerenderBatchSize, count);
+    for (; next < end; ++next) {
+        buttons[next % buttons.size()]->prerender(
+            modes[next / buttons.size()]);
     }
-    auto value = ::DWORD();
-    auto dwordBufferSize = ::DWORD(sizeof(::DWORD));
-    auto regQueryResult = ::RegQueryValueExW(handleKey,
-                                             L"ColorizationColor",
-                                             nullptr,
-                                             nullptr,
-                                             reinterpret_cast<LPBYTE>(&value),
-                                             &dwordBufferSize);
-    if (regQueryResult != ERROR_SUCCESS) {
-        return std::nullopt;
+    if (next < count) {
+        QTimer::singleShot(
+            0, this, [this, next]() { this->prerenderToolIcons(next); });
     }
-    return QColor(static_cast<QRgb>(value));
 }
-#endif
+
+void TitleBar::createProgressStrip() {
+    // Combined progress of all running tasks along the bottom edge, on top
+    // of the buttons. Only the main window title bar, which has the tool
+    // buttons, shows it.
+    this->m_progressStrip = new Internal::ProgressStrip(this);
+    this->m_progressStrip->setColor(
+        Utils::creatorTheme()->color(Utils::Theme::ProgressBarColorNormal));
+    this->updateProgressStripGeometry();
+    QObject::connect(Core::ProgressManager::instance(),
+                     &Core::ProgressManager::taskStarted,
+                     this,
+                     [this](Core::Id type) { this->watchStartedTask(type); });
+}
 
 TitleBar::~TitleBar() {
     auto *mainWindow = qobject_cast<QMainWindow *>(this->window());
@@ -488,132 +608,196 @@ TitleBar::~TitleBar() {
     this->m_menuBar = nullptr;
 }
 
-#if !defined(_WIN32) && !defined(__APPLE__)
 void TitleBar::mousePressEvent(QMouseEvent *event) {
-    if (!QX11Info::isPlatformX11() || event->button() != Qt::LeftButton) {
-        QWidget::mousePressEvent(event);
-        return;
+    if (this->m_rendering == Rendering::Flyweight &&
+        event->button() == Qt::LeftButton) {
+        const int index = this->flyweightButtonAt(event->pos());
+        if (index >= 0) {
+            this->m_flyweightPressed = index;
+            this->setFlyweightHovered(index);
+            this->updateCaptionButton(static_cast<std::size_t>(index));
+            return;
+        }
     }
 
+#if !defined(_WIN32) && !defined(__APPLE__)
     QWidget *tlw = titleBarTopLevelWidget(this);
 
-    if (tlw->isWindow() && tlw->windowHandle() &&
+    if (QX11Info::isPlatformX11() && event->button() == Qt::LeftButton &&
+        tlw->isWindow() && tlw->windowHandle() &&
         !(tlw->windowFlags() & Qt::X11BypassWindowManagerHint) &&
         !tlw->testAttribute(Qt::WA_DontShowOnScreen) &&
         !tlw->hasHeightForWidth()) {
         QPlatformWindow *platformWindow = tlw->windowHandle()->handle();
+        QScreen *screen = platformWindow->screen()->screen();
         const QPoint globalPos = QHighDpi::toNativePixels(
             platformWindow->mapToGlobal(this->mapTo(tlw, event->pos())),
-            platformWindow->screen()->screen());
-
-        const xcb_atom_t moveResizeAtom = []() -> xcb_atom_t {
-            xcb_intern_atom_cookie_t cookie = xcb_intern_atom(
-                QX11Info::connection(),
-                false,
-                static_cast<std::uint16_t>(std::strlen(_NET_WM_MOVERESIZE)),
-                _NET_WM_MOVERESIZE);
-            xcb_intern_atom_reply_t *reply =
-                xcb_intern_atom_reply(QX11Info::connection(), cookie, nullptr);
-            const xcb_atom_t moveResizeAtomCopy = reply->atom;
-            free(reply);
-            return moveResizeAtomCopy;
-        }();
-
-        xcb_client_message_event_t xev;
-        xev.response_type = XCB_CLIENT_MESSAGE;
-        xev.type = moveResizeAtom;
-        xev.sequence = 0;
-        xev.window = static_cast<xcb_window_t>(platformWindow->winId());
-        xev.format = 32;
-        xev.data.data32[0] = static_cast<std::uint32_t>(globalPos.x());
-        xev.data.data32[1] = static_cast<std::uint32_t>(globalPos.y());
-        xev.data.data32[2] = 8; // move
-        xev.data.data32[3] = XCB_BUTTON_INDEX_1;
-        xev.data.data32[4] = 0;
-
-        const xcb_window_t rootWindow = [platformWindow]() -> xcb_window_t {
-            xcb_query_tree_cookie_t queryTreeCookie = xcb_query_tree(
-                QX11Info::connection(),
-                static_cast<xcb_window_t>(platformWindow->winId()));
-            xcb_query_tree_reply_t *queryTreeReply = xcb_query_tree_reply(
-                QX11Info::connection(), queryTreeCookie, nullptr);
-            xcb_window_t rootWindowCopy = queryTreeReply->root;
-            free(queryTreeReply);
-            return rootWindowCopy;
-        }();
-
-        std::uint32_t eventFlags = XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT |
-                                   XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY;
-
-        xcb_ungrab_pointer(QX11Info::connection(), XCB_CURRENT_TIME);
-        xcb_send_event(QX11Info::connection(),
-                       false,
-                       rootWindow,
-                       eventFlags,
-                       reinterpret_cast<const char *>(&xev));
+            screen);
+
+        if (Internal::X11MoveResize::instance().start(
+                static_cast<xcb_window_t>(platformWindow->winId()),
+                screen,
+                globalPos,
+                Internal::X11MoveResize::Move)) {
+            return;
+        }
     }
-}
 #endif
+    QWidget::mousePressEvent(event);
+}
 
-void TitleBar::paintEvent([[maybe_unused]] QPaintEvent *event) {
-    auto styleOption = QStyleOption();
-    styleOption.init(this);
-    auto painter = QPainter(this);
-    this->style()->drawPrimitive(
-        QStyle::PE_Widget, &styleOption, &painter, this);
+void TitleBar::mouseMoveEvent(QMouseEvent *event) {
+    if (this->m_rendering == Rendering::Flyweight) {
+        // Like a pressed button widget, which grabs the mouse, a pressed
+        // flyweight button is the only one that can be hovered
+        int index = this->flyweightButtonAt(event->pos());
+        if (this->m_flyweightPressed >= 0 &&
+            index != this->m_flyweightPressed) {
+            index = -1;
+        }
+        this->setFlyweightHovered(index);
+    }
+    QWidget::mouseMoveEvent(event);
 }
 
-bool TitleBar::isActive() const {
-    return this->m_active;
+void TitleBar::mouseReleaseEvent(QMouseEvent *event) {
+    if (this->m_rendering == Rendering::Flyweight &&
+        event->button() == Qt::LeftButton && this->m_flyweightPressed >= 0) {
+        const auto index = static_cast<std::size_t>(this->m_flyweightPressed);
+        const bool clicked =
+            this->m_flyweightHovered == this->m_flyweightPressed;
+        this->m_flyweightPressed = -1;
+        this->setFlyweightHovered(this->flyweightButtonAt(event->pos()));
+        this->updateCaptionButton(index);
+        if (clicked) {
+            this->emitCaptionButtonClicked(
+                this->m_flyweightButtons[index].role);
+        }
+        return;
+    }
+    QWidget::mouseReleaseEvent(event);
 }
 
-void TitleBar::setActive(bool active) {
-    this->m_active = active;
-    if (active) {
-        auto palette = this->palette();
-        palette.setColor(QPalette::Window, this->m_activeColor);
-        this->setPalette(palette);
-    } else {
-        auto palette = this->palette();
-        palette.setColor(QPalette::Window, QColor(33, 37, 43));
-        this->setPalette(palette);
+void TitleBar::leaveEvent(QEvent *event) {
+    // The title bar is also left when the mouse enters a child widget
+    if (this->m_rendering == Rendering::Flyweight &&
+        this->m_flyweightPressed < 0) {
+        this->setFlyweightHovered(-1);
+    }
+    QWidget::leaveEvent(event);
+}
+
+bool TitleBar::event(QEvent *event) {
+    // Layouts are activated before the widget sees these events, so child
+    // geometries are final here
+    const bool result = QWidget::event(event);
+    switch (event->type()) {
+    case QEvent::Resize: {
+        this->updateProgressStripGeometry();
+        this->rebuildDragRegion();
+        break;
+    }
+    case QEvent::LayoutRequest:
+    case QEvent::Show: {
+        this->rebuildDragRegion();
+        break;
+    }
+    case QEvent::StyleChange: {
+        this->updateBackground();
+        break;
+    }
+    default:
+        break;
+    }
+    return result;
+}
+
+void TitleBar::paintEvent(QPaintEvent *event) {
+    auto painter = QPainter(this);
+    painter.fillRect(event->rect(), this->backgroundColor());
+    if (this->usesStyleSheet()) {
+        auto styleOption = QStyleOption();
+        styleOption.init(this);
+        this->style()->drawPrimitive(
+            QStyle::PE_Widget, &styleOption, &painter, this);
+    }
+
+    const QRect captionIconRect = this->m_captionIconItem->geometry();
+    if (event->rect().intersects(captionIconRect)) {
+        QRect iconRect(QPoint(0, 0), this->m_captionIconSize);
+        iconRect.moveCenter(captionIconRect.center());
+        painter.drawPixmap(
+            iconRect,
+            Internal::IconCache::instance().iconPixmap(
+                this->m_captionIcon,
+                this->m_captionIconSize,
+                this->devicePixelRatioF()));
     }
 
-    auto iconsPaths =
-        Internal::captionIconPathsForState(this->m_active,
-                                           this->m_maximized,
-                                           false,
-                                           false,
-                                           this->m_captionButtonStyle);
+    if (this->m_rendering != Rendering::Flyweight) {
+        return;
+    }
+    const auto pressedOffset = QPoint(
+        this->style()->pixelMetric(
+            QStyle::PM_ButtonShiftHorizontal, nullptr, this),
+        this->style()->pixelMetric(
+            QStyle::PM_ButtonShiftVertical, nullptr, this));
+    const QSize iconSize =
+        captionButtonIconSize(this->m_visualState.style());
+    for (std::size_t i = 0; i < this->m_flyweightButtons.size(); ++i) {
+        const FlyweightButton &button = this->m_flyweightButtons[i];
+        const QRect buttonRect = button.item->geometry();
+        if (!button.visible || !event->rect().intersects(buttonRect)) {
+            continue;
+        }
+        TitleBarButton::paintCaption(
+            painter,
+            *this,
+            TitleBarButton::CaptionPaint{
+                button.role,
+                buttonRect,
+                iconSize,
+                pressedOffset,
+                this->m_hoverColor,
+                this->m_fadeAnimator->value(button.fadeSlot),
+                this->isEnabled(),
+                this->isCaptionButtonUnderMouse(i),
+                this->isCaptionButtonDown(i),
+                this->devicePixelRatioF()});
+    }
+}
 
-    this->m_buttonMinimize->setIcon(QIcon(iconsPaths[0].toString()));
-    this->m_buttonMaximizeRestore->setIcon(QIcon(iconsPaths[1].toString()));
-    this->m_buttonClose->setIcon(QIcon(iconsPaths[2].toString()));
+bool TitleBar::isActive() const {
+    return this->m_visualState.isActive();
+}
+
+void TitleBar::setActive(bool active) {
+    ++this->m_repaintCounters.events;
+    this->applyVisualState(this->m_visualState.withActive(active));
 }
 
 bool TitleBar::isMaximized() const {
-    return this->m_maximized;
+    return this->m_visualState.isMaximized();
 }
 
 void TitleBar::setMaximized(bool maximized) {
-    this->m_maximized = maximized;
-    auto iconsPaths =
-        Internal::captionIconPathsForState(this->m_active,
-                                           this->m_maximized,
-                                           false,
-                                           false,
-                                           this->m_captionButtonStyle);
-
-    this->m_buttonMinimize->setIcon(QIcon(iconsPaths[0].toString()));
-    this->m_buttonMaximizeRestore->setIcon(QIcon(iconsPaths[1].toString()));
-    this->m_buttonClose->setIcon(QIcon(iconsPaths[2].toString()));
+    ++this->m_repaintCounters.events;
+    this->applyVisualState(this->m_visualState.withMaximized(maximized));
 }
 
 void TitleBar::setMinimizable(bool on) {
+    if (this->m_rendering == Rendering::Flyweight) {
+        this->setFlyweightVisible(0, on);
+        return;
+    }
     this->m_buttonMinimize->setVisible(on);
 }
 
 void TitleBar::setMaximizable(bool on) {
+    if (this->m_rendering == Rendering::Flyweight) {
+        this->setFlyweightVisible(1, on);
+        return;
+    }
     this->m_buttonMaximizeRestore->setVisible(on);
 }
 
@@ -632,93 +816,376 @@ QColor TitleBar::hoverColor() const {
 
 void TitleBar::setHoverColor(QColor hoverColor) {
     this->m_hoverColor = std::move(hoverColor);
+    if (this->m_rendering == Rendering::Flyweight) {
+        this->updateCaptionButton(0);
+        this->updateCaptionButton(1);
+        return;
+    }
     this->m_buttonMinimize->setHoverColor(this->m_hoverColor);
     this->m_buttonMaximizeRestore->setHoverColor(this->m_hoverColor);
 }
 
+const Internal::CaptionGlyphColors &TitleBar::captionGlyphColors() const {
+    return this->m_captionGlyphColors;
+}
+
+void TitleBar::setCaptionGlyphColors(
+    const Internal::CaptionGlyphColors &colors) {
+    if (colors == this->m_captionGlyphColors) {
+        return;
+    }
+    // The glyph masks stay cached, so switching colors only re-tints them
+    this->m_captionGlyphColors = colors;
+    this->triggerCaptionRepaint();
+}
+
+TitleBar::Rendering TitleBar::rendering() const {
+    return this->m_rendering;
+}
+
 CaptionButtonStyle TitleBar::captionButtonStyle() const {
-    return this->m_captionButtonStyle;
+    return this->m_visualState.style();
 }
 
 void TitleBar::setCaptionButtonStyle(CaptionButtonStyle captionButtonStyle) {
-    this->m_captionButtonStyle = captionButtonStyle;
+    ++this->m_repaintCounters.events;
+    if (captionButtonStyle == this->m_visualState.style()) {
+        return;
+    }
 
-    auto iconSize = this->m_captionButtonStyle == CaptionButtonStyle::mac
-                        ? QSize(16, 16)
-                        : QSize(12, 12);
-    int requiredWidth = 0;
-    switch (this->m_captionButtonStyle) {
-    case CaptionButtonStyle::custom: {
-        requiredWidth = 30;
-        break;
+    const QSize iconSize = captionButtonIconSize(captionButtonStyle);
+    const int requiredWidth = captionButtonWidth(captionButtonStyle);
+    if (this->m_rendering == Rendering::Flyweight) {
+        for (const FlyweightButton &button : this->m_flyweightButtons) {
+            button.item->changeSize(button.visible ? requiredWidth : 0,
+                                    30,
+                                    QSizePolicy::Fixed,
+                                    QSizePolicy::Fixed);
+        }
+        this->m_horizontalLayout->invalidate();
+    } else {
+        for (TitleBarButton *button : this->captionButtons()) {
+            button->setIconSize(iconSize);
+            button->setMinimumWidth(requiredWidth);
+            button->setMaximumWidth(requiredWidth);
+        }
     }
-    case CaptionButtonStyle::win: {
-        requiredWidth = 46;
-        break;
+    this->prerasterizeCaptionIcons(captionButtonStyle);
+
+    this->applyVisualState(
+        this->m_visualState.withStyle(captionButtonStyle));
+}
+
+void TitleBar::onWindowStateChange(Qt::WindowStates state) {
+    ++this->m_repaintCounters.events;
+    this->applyVisualState(
+        this->m_visualState.withActive(this->window()->isActiveWindow())
+            .withMaximized(static_cast<bool>(state & Qt::WindowMaximized)));
+}
+
+void TitleBar::scheduleWindowStateSync() {
+    // Dialogs and popups flip activation several times per frame; only the
+    // state the window ends up in is applied
+    ++this->m_windowEventCounters.received;
+    if (this->m_windowStateSyncPending) {
+        return;
     }
-    case CaptionButtonStyle::mac: {
-        requiredWidth = 26;
-        break;
+    this->m_windowStateSyncPending = true;
+    QTimer::singleShot(0, this, [this]() { this->syncWindowState(); });
+}
+
+bool TitleBar::hovered() const {
+    return this->isCaptionAt(this->mapFromGlobal(QCursor::pos()));
+}
+
+bool TitleBar::isCaptionAt(const QPoint &pos) const {
+    return this->m_dragRegion.isDraggable(pos);
+}
+
+const Internal::DragRegion &TitleBar::dragRegion() const {
+    return this->m_dragRegion;
+}
+
+Internal::FadeAnimator *TitleBar::fadeAnimator() const {
+    return this->m_fadeAnimator;
+}
+
+Internal::ToolIconCache &TitleBar::toolIconCache() {
+    return this->m_toolIconCache;
+}
+
+bool TitleBar::isCaptionButtonHovered() const {
+    return this->m_visualState.isCaptionHovered();
+}
+
+void TitleBar::onButtonHoverChanged(TitleBarButton *button) {
+    ++this->m_repaintCounters.events;
+    const std::array<TitleBarButton *, 3> buttons = this->captionButtons();
+    bool captionHovered = false;
+    unsigned int hoverChangedButtons = 0;
+    for (std::size_t i = 0; i < buttons.size(); ++i) {
+        captionHovered = captionHovered || buttons[i]->underMouse();
+        if (buttons[i] == button) {
+            hoverChangedButtons |= 1u << i;
+        }
     }
+    this->applyVisualState(
+        this->m_visualState.withCaptionHovered(captionHovered),
+        hoverChangedButtons);
+}
+
+void TitleBar::triggerCaptionRepaint() {
+    this->m_repaintCounters.repaints += 3;
+    for (std::size_t i = 0; i < this->m_flyweightButtons.size(); ++i) {
+        this->updateCaptionButton(i);
     }
-    this->m_buttonMinimize->setIconSize(iconSize);
-    this->m_buttonMinimize->setMinimumWidth(requiredWidth);
-    this->m_buttonMinimize->setMaximumWidth(requiredWidth);
-    this->m_buttonMaximizeRestore->setIconSize(iconSize);
-    this->m_buttonMaximizeRestore->setMinimumWidth(requiredWidth);
-    this->m_buttonMaximizeRestore->setMaximumWidth(requiredWidth);
-    this->m_buttonClose->setIconSize(iconSize);
-    this->m_buttonClose->setMinimumWidth(requiredWidth);
-    this->m_buttonClose->setMaximumWidth(requiredWidth);
+}
 
-    auto iconsPaths =
-        Internal::captionIconPathsForState(this->m_active,
-                                           this->m_maximized,
-                                           false,
-                                           false,
-                                           this->m_captionButtonStyle);
+Internal::ProgressStrip *TitleBar::progressStrip() const {
+    return this->m_progressStrip;
+}
 
-    this->m_buttonMinimize->setIcon(QIcon(iconsPaths[0].toString()));
-    this->m_buttonMaximizeRestore->setIcon(QIcon(iconsPaths[1].toString()));
-    this->m_buttonClose->setIcon(QIcon(iconsPaths[2].toString()));
+Internal::ActionBindingCounters TitleBar::actionBindingCounters() const {
+    Internal::ActionBindingCounters counters;
+    for (const Internal::ActionBinding *binding :
+         {this->m_bindingRun, this->m_bindingDebug, this->m_bindingBuild}) {
+        if (binding == nullptr) {
+            continue;
+        }
+        counters.received += binding->counters().received;
+        counters.applied += binding->counters().applied;
+    }
+    return counters;
 }
 
-void TitleBar::onWindowStateChange(Qt::WindowStates state) {
-    this->setActive(this->window()->isActiveWindow());
-    this->setMaximized(static_cast<bool>(state & Qt::WindowMaximized));
+const Internal::RepaintCounters &TitleBar::repaintCounters() const {
+    return this->m_repaintCounters;
 }
 
-bool TitleBar::hovered() const {
-    auto cursorPos = QCursor::pos();
-    bool hovered = this->rect().contains(this->mapFromGlobal(cursorPos));
-    if (!hovered) {
-        return false;
+void TitleBar::resetActionBindingCounters() {
+    for (Internal::ActionBinding *binding :
+         {this->m_bindingRun, this->m_bindingDebug, this->m_bindingBuild}) {
+        if (binding == nullptr) {
+            continue;
+        }
+        binding->resetCounters();
+    }
+}
+
+void TitleBar::resetRepaintCounters() {
+    this->m_repaintCounters = Internal::RepaintCounters();
+}
+
+const Internal::WindowEventCounters &
+TitleBar::windowEventCounters() const {
+    return this->m_windowEventCounters;
+}
+
+void TitleBar::resetWindowEventCounters() {
+    this->m_windowEventCounters = Internal::WindowEventCounters();
+}
+
+void TitleBar::syncWindowState() {
+    this->m_windowStateSyncPending = false;
+    ++this->m_windowEventCounters.applied;
+    this->onWindowStateChange(this->window()->windowState());
+}
+
+void TitleBar::applyVisualState(Internal::VisualState state,
+                                unsigned int hoverChangedButtons) {
+    const Internal::VisualState previous = this->m_visualState;
+    if (state == previous && hoverChangedButtons == 0) {
+        return;
     }
+    this->m_visualState = state;
 
-    if (this->m_menuBar->rect().contains(
-            this->m_menuBar->mapFromGlobal(cursorPos))) {
-        return false;
+    if (state.isActive() != previous.isActive()) {
+        this->updateBackground();
     }
 
-    for (const TitleBarButton *btn : this->findChildren<TitleBarButton *>()) {
-        bool btnHovered = btn->rect().contains(btn->mapFromGlobal(cursorPos));
-        if (btnHovered) {
-            return false;
+    // Only repaint the caption buttons whose glyph differs between the two
+    // states. A button whose hover changed was hovered exactly when it is
+    // not hovered now.
+    for (std::size_t i = 0; i < this->m_flyweightButtons.size(); ++i) {
+        if (!this->isCaptionButtonVisible(i)) {
+            continue;
+        }
+        const bool underMouse = this->isCaptionButtonUnderMouse(i);
+        const bool wasUnderMouse =
+            (hoverChangedButtons & (1u << i)) != 0 ? !underMouse : underMouse;
+        const bool down = this->isCaptionButtonDown(i);
+        const auto iconForState = [down, i](Internal::VisualState s,
+                                            bool buttonHovered) {
+            const bool hovered =
+                buttonHovered || (s.style() == CaptionButtonStyle::mac &&
+                                  s.isCaptionHovered());
+            return Internal::captionIconsForState(s.style(),
+                                                  s.isActive(),
+                                                  s.isMaximized(),
+                                                  hovered,
+                                                  hovered && down)[i];
+        };
+        if (iconForState(previous, wasUnderMouse) !=
+            iconForState(state, underMouse)) {
+            ++this->m_repaintCounters.repaints;
+            this->updateCaptionButton(i);
         }
     }
-    return true;
 }
 
-bool TitleBar::isCaptionButtonHovered() const {
-    return this->m_buttonMinimize->underMouse() ||
-           this->m_buttonMaximizeRestore->underMouse() ||
-           this->m_buttonClose->underMouse();
+std::array<TitleBarButton *, 3> TitleBar::captionButtons() const {
+    return {this->m_buttonMinimize,
+            this->m_buttonMaximizeRestore,
+            this->m_buttonClose};
 }
 
-void TitleBar::triggerCaptionRepaint() {
-    this->m_buttonMinimize->update();
-    this->m_buttonMaximizeRestore->update();
-    this->m_buttonClose->update();
+bool TitleBar::isCaptionButtonVisible(std::size_t index) const {
+    if (this->m_rendering == Rendering::Flyweight) {
+        return this->m_flyweightButtons[index].visible;
+    }
+    return this->captionButtons()[index]->isVisible();
+}
+
+bool TitleBar::isCaptionButtonUnderMouse(std::size_t index) const {
+    if (this->m_rendering == Rendering::Flyweight) {
+        return this->m_flyweightHovered == static_cast<int>(index);
+    }
+    return this->captionButtons()[index]->underMouse();
+}
+
+bool TitleBar::isCaptionButtonDown(std::size_t index) const {
+    // As with QAbstractButton, a pressed button is only down while the mouse
+    // is over it
+    if (this->m_rendering == Rendering::Flyweight) {
+        return this->m_flyweightPressed == static_cast<int>(index) &&
+               this->m_flyweightHovered == static_cast<int>(index);
+    }
+    return this->captionButtons()[index]->isDown();
+}
+
+void TitleBar::updateCaptionButton(std::size_t index) {
+    if (this->m_rendering == Rendering::Flyweight) {
+        this->update(this->m_flyweightButtons[index].item->geometry());
+        return;
+    }
+    this->captionButtons()[index]->update();
+}
+
+int TitleBar::flyweightButtonAt(const QPoint &pos) const {
+    for (std::size_t i = 0; i < this->m_flyweightButtons.size(); ++i) {
+        const FlyweightButton &button = this->m_flyweightButtons[i];
+        if (button.visible && button.item->geometry().contains(pos)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void TitleBar::setFlyweightHovered(int index) {
+    if (index == this->m_flyweightHovered) {
+        return;
+    }
+    unsigned int hoverChangedButtons = 0;
+    for (const int changed : {this->m_flyweightHovered, index}) {
+        if (changed < 0) {
+            continue;
+        }
+        hoverChangedButtons |= 1u << changed;
+        this->m_fadeAnimator->fadeTo(
+            this->m_flyweightButtons[static_cast<std::size_t>(changed)]
+                .fadeSlot,
+            changed == index ? 1.0 : 0.0);
+    }
+    this->m_flyweightHovered = index;
+    if (this->m_flyweightPressed >= 0) {
+        // The pressed button goes up and down with the hover
+        this->updateCaptionButton(
+            static_cast<std::size_t>(this->m_flyweightPressed));
+    }
+    ++this->m_repaintCounters.events;
+    this->applyVisualState(
+        this->m_visualState.withCaptionHovered(index >= 0),
+        hoverChangedButtons);
+}
+
+void TitleBar::setFlyweightVisible(std::size_t index, bool visible) {
+    FlyweightButton &button = this->m_flyweightButtons[index];
+    if (button.visible == visible) {
+        return;
+    }
+    if (this->m_flyweightPressed == static_cast<int>(index)) {
+        this->m_flyweightPressed = -1;
+    }
+    if (this->m_flyweightHovered == static_cast<int>(index)) {
+        this->setFlyweightHovered(-1);
+    }
+    button.visible = visible;
+    // The layout request posted by invalidate() rebuilds the drag region
+    button.item->changeSize(
+        visible ? captionButtonWidth(this->m_visualState.style()) : 0,
+        30,
+        QSizePolicy::Fixed,
+        QSizePolicy::Fixed);
+    this->m_horizontalLayout->invalidate();
+}
+
+void TitleBar::emitCaptionButtonClicked(TitleBarButton::Role role) {
+    switch (role) {
+    case TitleBarButton::Minimize: {
+        emit this->minimizeClicked();
+        break;
+    }
+    case TitleBarButton::MaximizeRestore: {
+        emit this->maximizeRestoreClicked();
+        break;
+    }
+    case TitleBarButton::Close: {
+        emit this->closeClicked();
+        break;
+    }
+    case TitleBarButton::Tool:
+        break;
+    }
+}
+
+void TitleBar::rebuildDragRegion() {
+    const auto buttons = this->findChildren<TitleBarButton *>(
+        QString(), Qt::FindDirectChildrenOnly);
+    auto rects = std::vector<QRect>();
+    rects.reserve(static_cast<std::size_t>(buttons.size()) + 4);
+    for (const TitleBarButton *button : buttons) {
+        if (!button->isHidden()) {
+            rects.push_back(button->geometry());
+        }
+    }
+    if (this->m_menuBar != nullptr && !this->m_menuBar->isHidden()) {
+        rects.push_back(this->m_menuBar->geometry());
+    }
+    if (this->m_rendering == Rendering::Flyweight) {
+        for (const FlyweightButton &button : this->m_flyweightButtons) {
+            if (button.visible) {
+                rects.push_back(button.item->geometry());
+            }
+        }
+    }
+    this->m_dragRegion.setBounds(this->rect());
+    this->m_dragRegion.setInteractiveRects(std::move(rects));
+}
+
+void TitleBar::updateBackground() {
+    // Without a style sheet the background is one solid fill, so paintEvent
+    // covers every pixel and neither the palette nor the style is involved
+    this->setAttribute(Qt::WA_OpaquePaintEvent, !this->usesStyleSheet());
+    this->update();
+}
+
+bool TitleBar::usesStyleSheet() const {
+    return this->style()->inherits("QStyleSheetStyle");
+}
+
+QColor TitleBar::backgroundColor() const {
+    return this->m_visualState.isActive() ? this->m_activeColor
+                                          : QColor(33, 37, 43);
 }
 
 void TitleBar::resetModeButtonStates() {
@@ -730,115 +1197,61 @@ void TitleBar::resetModeButtonStates() {
     this->m_buttonModeHelp->setKeepDown(false);
 }
 
-namespace Internal {
-
-std::array<QStringView, 3> captionIconPathsForState(bool active,
-                                                    bool maximized,
-                                                    bool hovered,
-                                                    bool pressed,
-                                                    CaptionButtonStyle style) {
-    std::array<QStringView, 3> buf;
+void TitleBar::updateProgressStripGeometry() {
+    if (this->m_progressStrip == nullptr) {
+        return;
+    }
+    auto stripRect = this->rect();
+    stripRect.setTop(stripRect.bottom() - progressStripHeight + 1);
+    this->m_progressStrip->setGeometry(stripRect);
+}
 
-    switch (style) {
-    case CaptionButtonStyle::custom: {
-        if (active || hovered) {
-            buf[0] = u":/resources/titlebar/custom/chrome-minimize-dark.svg";
-            if (maximized) {
-                buf[1] =
-                    u":/resources/titlebar/custom/chrome-restore-dark.svg";
-            } else {
-                buf[1] =
-                    u":/resources/titlebar/custom/chrome-maximize-dark.svg";
-            }
-            if (hovered) {
-                buf[2] = u":/resources/titlebar/custom/chrome-close-light.svg";
-            } else {
-                buf[2] = u":/resources/titlebar/custom/chrome-close-dark.svg";
+void TitleBar::watchStartedTask(Core::Id type) {
+    // taskStarted is emitted right after the progress widget of the task was
+    // added to the progress view, so it is the newest child of that type.
+    // Widgets of finished tasks stay in the view while they fade out and are
+    // skipped. The view is looked up once, when the first task starts.
+    if (this->m_progressView.isNull()) {
+        const auto topLevelWidgets = QApplication::topLevelWidgets();
+        for (const QWidget *topLevelWidget : topLevelWidgets) {
+            const auto *progress =
+                topLevelWidget->findChild<Core::FutureProgress *>();
+            if (progress != nullptr) {
+                this->m_progressView = progress->parentWidget();
+                break;
             }
-        } else {
-            buf[0] = u":/resources/titlebar/custom/"
-                     u"chrome-minimize-dark-disabled.svg";
-            if (maximized) {
-                buf[1] = u":/resources/titlebar/custom/"
-                         u"chrome-restore-dark-disabled.svg";
-            } else {
-                buf[1] = u":/resources/titlebar/custom/"
-                         u"chrome-maximize-dark-disabled.svg";
-            }
-            buf[2] =
-                u":/resources/titlebar/custom/chrome-close-dark-disabled.svg";
         }
-        break;
-    }
-    case CaptionButtonStyle::win: {
-        if (active || hovered) {
-            buf[0] = u":/resources/titlebar/win/chrome-minimize-dark.svg";
-            if (maximized) {
-                buf[1] = u":/resources/titlebar/win/chrome-restore-dark.svg";
-            } else {
-                buf[1] = u":/resources/titlebar/win/chrome-maximize-dark.svg";
-            }
-            if (hovered) {
-                buf[2] = u":/resources/titlebar/win/chrome-close-light.svg";
-            } else {
-                buf[2] = u":/resources/titlebar/win/chrome-close-dark.svg";
-            }
-        } else {
-            buf[0] =
-                u":/resources/titlebar/win/chrome-minimize-dark-disabled.svg";
-            if (maximized) {
-                buf[1] = u":/resources/titlebar/win/"
-                         u"chrome-restore-dark-disabled.svg";
-            } else {
-                buf[1] = u":/resources/titlebar/win/"
-                         u"chrome-maximize-dark-disabled.svg";
-            }
-            buf[2] =
-                u":/resources/titlebar/win/chrome-close-dark-disabled.svg";
+        if (this->m_progressView.isNull()) {
+            return;
         }
-        break;
     }
-    case CaptionButtonStyle::mac: {
-        if (pressed) {
-            buf[0] = u":/resources/titlebar/mac/minimize-pressed.png";
-            if (maximized) {
-                buf[1] = u":/resources/titlebar/mac/"
-                         "maximize-restore-maximized-pressed.png";
-            } else {
-                buf[1] = u":/resources/titlebar/mac/"
-                         u"maximize-restore-normal-pressed.png";
-            }
-            buf[2] = u":/resources/titlebar/mac/close-pressed.png";
-        } else {
-            if (hovered) {
-                buf[0] = u":/resources/titlebar/mac/minimize-hovered.png";
-                if (maximized) {
-                    buf[1] = u":/resources/titlebar/mac/"
-                             u"maximize-restore-maximized-hovered.png";
-                } else {
-                    buf[1] = u":/resources/titlebar/mac/"
-                             u"maximize-restore-normal-hovered.png";
-                }
-                buf[2] = u":/resources/titlebar/mac/close-hovered.png";
-            } else {
-                if (active) {
-                    buf[0] = u":/resources/titlebar/mac/minimize.png";
-                    buf[1] = u":/resources/titlebar/mac/maximize-restore.png";
-                    buf[2] = u":/resources/titlebar/mac/close.png";
-                } else {
-                    buf[0] = u":/resources/titlebar/mac/inactive.png";
-                    buf[1] = u":/resources/titlebar/mac/inactive.png";
-                    buf[2] = u":/resources/titlebar/mac/inactive.png";
-                }
-            }
+
+    const QObjectList &children = this->m_progressView->children();
+    for (auto it = children.crbegin(); it != children.crend(); ++it) {
+        const auto *progress = qobject_cast<Core::FutureProgress *>(*it);
+        if (progress != nullptr && progress->type() == type &&
+            !progress->future().isFinished()) {
+            this->m_progressStrip->watch(progress->future());
+            return;
         }
-        break;
-    }
     }
+}
 
-    return buf;
+void TitleBar::setStartupProjectBuilding(bool building) {
+    if (this->m_startupProjectBuilding == building) {
+        return;
+    }
+    this->m_startupProjectBuilding = building;
+    this->m_bindingBuild->scheduleUpdate();
 }
 
-} // namespace Internal
+void TitleBar::setToolButtonIcon(TitleBarButton *button, const QIcon &icon) {
+    const qint64 previousCacheKey = button->icon().cacheKey();
+    if (previousCacheKey == icon.cacheKey()) {
+        return;
+    }
+    this->m_toolIconCache.invalidate(previousCacheKey);
+    button->setIcon(icon);
+}
 
 } // namespace CSD
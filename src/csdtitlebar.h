@@ -1,23 +1,36 @@
 #pragma once
 
 #include "captionbuttonstyle.h"
+#include "csddragregion.h"
+#include "csdiconcache.h"
+#include "csdtitlebarbutton.h"
+#include "csdvisualstate.h"
+
+#include <coreplugin/id.h>
 
 #include <QColor>
 #include <QIcon>
-#include <QStringView>
+#include <QPointer>
 #include <QWidget>
 
 #include <array>
+#include <cstddef>
 #include <optional>
 
 class QHBoxLayout;
 class QLayout;
 class QLabel;
 class QMenuBar;
+class QSpacerItem;
 
 namespace CSD {
 
-class TitleBarButton;
+namespace Internal {
+class ActionBinding;
+struct ActionBindingCounters;
+class FadeAnimator;
+class ProgressStrip;
+} // namespace Internal
 
 class TitleBar : public QWidget {
     Q_OBJECT
@@ -28,38 +41,77 @@ private:
 #ifdef _WIN32
     std::optional<QColor> readDWMColorizationColor();
 #endif
-    bool m_active = false;
-    bool m_maximized = false;
+    // A caption button in flyweight rendering: the layout item reserving
+    // its space and the state a TitleBarButton would keep
+    struct FlyweightButton {
+        TitleBarButton::Role role = TitleBarButton::Close;
+        QSpacerItem *item = nullptr;
+        std::size_t fadeSlot = 0;
+        bool visible = true;
+    };
+
+    Internal::VisualState m_visualState;
+    Internal::RepaintCounters m_repaintCounters;
+    Internal::WindowEventCounters m_windowEventCounters;
+    bool m_windowStateSyncPending = false;
     QColor m_activeColor;
     QColor m_hoverColor = QColor(62, 68, 81);
+    Internal::CaptionGlyphColors m_captionGlyphColors;
+    Internal::FadeAnimator *m_fadeAnimator;
+    Internal::ProgressStrip *m_progressStrip = nullptr;
+    QPointer<QWidget> m_progressView;
+    Internal::ToolIconCache m_toolIconCache;
+    Internal::DragRegion m_dragRegion;
     QHBoxLayout *m_horizontalLayout;
-    QMenuBar *m_menuBar;
-    QWidget *m_leftMargin;
-    CaptionButtonStyle m_captionButtonStyle;
-    TitleBarButton *m_buttonCaptionIcon;
-    TitleBarButton *m_buttonRun;
-    TitleBarButton *m_buttonDebug;
-    TitleBarButton *m_buttonBuild;
-    TitleBarButton *m_buttonModeWelcome;
-    TitleBarButton *m_buttonModeEdit;
-    TitleBarButton *m_buttonModeDesign;
-    TitleBarButton *m_buttonModeDebug;
-    TitleBarButton *m_buttonModeProjects;
-    TitleBarButton *m_buttonModeHelp;
-    TitleBarButton *m_buttonMinimize;
-    TitleBarButton *m_buttonMaximizeRestore;
-    TitleBarButton *m_buttonClose;
+    QMenuBar *m_menuBar = nullptr;
+    QSpacerItem *m_leftMargin;
+    QSpacerItem *m_captionIconItem;
+    QIcon m_captionIcon;
+    QSize m_captionIconSize;
+    int m_toolButtonsIndex = 0;
+    TitleBarButton *m_buttonRun = nullptr;
+    TitleBarButton *m_buttonDebug = nullptr;
+    TitleBarButton *m_buttonBuild = nullptr;
+    Internal::ActionBinding *m_bindingRun = nullptr;
+    Internal::ActionBinding *m_bindingDebug = nullptr;
+    Internal::ActionBinding *m_bindingBuild = nullptr;
+    bool m_startupProjectBuilding = false;
+    TitleBarButton *m_buttonModeWelcome = nullptr;
+    TitleBarButton *m_buttonModeEdit = nullptr;
+    TitleBarButton *m_buttonModeDesign = nullptr;
+    TitleBarButton *m_buttonModeDebug = nullptr;
+    TitleBarButton *m_buttonModeProjects = nullptr;
+    TitleBarButton *m_buttonModeHelp = nullptr;
+    TitleBarButton *m_buttonMinimize = nullptr;
+    TitleBarButton *m_buttonMaximizeRestore = nullptr;
+    TitleBarButton *m_buttonClose = nullptr;
+    std::array<FlyweightButton, 3> m_flyweightButtons;
+    int m_flyweightHovered = -1;
+    int m_flyweightPressed = -1;
 
 protected:
-#if !defined(_WIN32) && !defined(__APPLE__)
     void mousePressEvent(QMouseEvent *event) override;
-#endif
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+    bool event(QEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
 
 public:
+    // Title bars of secondary windows only get the caption icon, the menu
+    // bar and the caption buttons. A CaptionOnly title bar can be completed
+    // later with createToolButtons().
+    enum class Controls { CaptionOnly, All };
+    // With Flyweight rendering, the caption buttons are not widgets: the
+    // title bar lays them out as layout items, tracks their hover and press
+    // state and paints them itself. Tool and mode buttons stay widgets.
+    enum class Rendering { Widgets, Flyweight };
+
     explicit TitleBar(CaptionButtonStyle captionButtonStyle,
                       const QIcon &captionIcon = QIcon(),
-                      QWidget *parent = nullptr);
+                      QWidget *parent = nullptr,
+                      Controls controls = Controls::All,
+                      Rendering rendering = Rendering::Widgets);
     ~TitleBar() override;
 
     bool isActive() const;
@@ -72,31 +124,72 @@ public:
     void setActiveColor(const QColor &activeColor);
     QColor hoverColor() const;
     void setHoverColor(QColor hoverColor);
+    // Only the custom and win glyphs are drawn and take these colors. The
+    // plugin keeps the defaults, which match the fixed dark title bar
+    // background; this is for applications linking csd_core.
+    const Internal::CaptionGlyphColors &captionGlyphColors() const;
+    void setCaptionGlyphColors(const Internal::CaptionGlyphColors &colors);
+    Rendering rendering() const;
     CaptionButtonStyle captionButtonStyle() const;
     void setCaptionButtonStyle(CaptionButtonStyle captionButtonStyle);
     void onWindowStateChange(Qt::WindowStates state);
+    void createToolButtons();
+    void scheduleWindowStateSync();
     bool hovered() const;
+    bool isCaptionAt(const QPoint &pos) const;
+    const Internal::DragRegion &dragRegion() const;
+
+    Internal::FadeAnimator *fadeAnimator() const;
+    Internal::ProgressStrip *progressStrip() const;
+    Internal::ToolIconCache &toolIconCache();
 
     bool isCaptionButtonHovered() const;
+    void onButtonHoverChanged(TitleBarButton *button);
     void triggerCaptionRepaint();
 
+    Internal::ActionBindingCounters actionBindingCounters() const;
+    void resetActionBindingCounters();
+    const Internal::RepaintCounters &repaintCounters() const;
+    void resetRepaintCounters();
+    const Internal::WindowEventCounters &windowEventCounters() const;
+    void resetWindowEventCounters();
+
 signals:
     void minimizeClicked();
     void maximizeRestoreClicked();
     void closeClicked();
 
 private:
+    Rendering m_rendering;
+
+    // hoverChangedButtons has bit i set for each caption button i whose
+    // hover state just flipped
+    void applyVisualState(Internal::VisualState state,
+                          unsigned int hoverChangedButtons = 0);
+    void createCaptionButtons(int width, const QSize &iconSize);
+    void createFlyweightButtons(int width);
+    std::array<TitleBarButton *, 3> captionButtons() const;
+    bool isCaptionButtonVisible(std::size_t index) const;
+    bool isCaptionButtonUnderMouse(std::size_t index) const;
+    bool isCaptionButtonDown(std::size_t index) const;
+    void updateCaptionButton(std::size_t index);
+    int flyweightButtonAt(const QPoint &pos) const;
+    void setFlyweightHovered(int index);
+    void setFlyweightVisible(std::size_t index, bool visible);
+    void emitCaptionButtonClicked(TitleBarButton::Role role);
+    void createProgressStrip();
+    void prerasterizeCaptionIcons(CaptionButtonStyle style);
+    void prerenderToolIcons(std::size_t next);
+    void updateProgressStripGeometry();
+    void syncWindowState();
+    void rebuildDragRegion();
+    void updateBackground();
+    bool usesStyleSheet() const;
+    QColor backgroundColor() const;
     void resetModeButtonStates();
+    void watchStartedTask(Core::Id type);
+    void setStartupProjectBuilding(bool building);
+    void setToolButtonIcon(TitleBarButton *button, const QIcon &icon);
 };
 
-namespace Internal {
-
-std::array<QStringView, 3> captionIconPathsForState(bool active,
-                                                    bool maximized,
-                                                    bool hovered,
-                                                    bool pressed,
-                                                    CaptionButtonStyle style);
-
-}
-
 } // namespace CSD
@@ -1,12 +1,13 @@
 #include "csdtitlebarbutton.h"
 
+#include "csdfadeanimator.h"
+#include "csdiconcache.h"
 #include "csdtitlebar.h"
 
 #include <utils/icon.h>
 #include <utils/stylehelper.h>
 
 #include <QEvent>
-#include <QPropertyAnimation>
 #include <QStyleOption>
 #include <QStylePainter>
 
@@ -26,15 +27,23 @@ TitleBarButton::TitleBarButton(const QIcon &icon,
                                TitleBar *parent)
     : QPushButton(icon, text, parent), m_role(role) {
     this->setAttribute(Qt::WidgetAttribute::WA_Hover, true);
+    if (parent != nullptr) {
+        this->m_fadeAnimator = parent->fadeAnimator();
+        this->m_fadeSlot = this->m_fadeAnimator->add(this);
+    }
 }
 
 double TitleBarButton::fader() const {
-    return this->m_fader;
+    if (this->m_fadeAnimator == nullptr) {
+        return 0.0;
+    }
+    return this->m_fadeAnimator->value(this->m_fadeSlot);
 }
 
 void TitleBarButton::setFader(double value) {
-    this->m_fader = value;
-    this->update();
+    if (this->m_fadeAnimator != nullptr) {
+        this->m_fadeAnimator->setValue(this->m_fadeSlot, value);
+    }
 }
 
 QColor TitleBarButton::hoverColor() const {
@@ -58,19 +67,16 @@ bool TitleBarButton::event(QEvent *event) {
     if (this->isDown()) {
         return QPushButton::event(event);
     }
+    if (this->m_fadeAnimator == nullptr) {
+        return QPushButton::event(event);
+    }
     switch (event->type()) {
     case QEvent::Enter: {
-        auto animation = new QPropertyAnimation(this, "fader");
-        animation->setDuration(125);
-        animation->setEndValue(1.0);
-        animation->start(QAbstractAnimation::DeleteWhenStopped);
+        this->m_fadeAnimator->fadeTo(this->m_fadeSlot, 1.0);
         break;
     }
     case QEvent::Leave: {
-        auto animation = new QPropertyAnimation(this, "fader");
-        animation->setDuration(125);
-        animation->setEndValue(0.0);
-        animation->start(QAbstractAnimation::DeleteWhenStopped);
+        this->m_fadeAnimator->fadeTo(this->m_fadeSlot, 0.0);
         break;
     }
     default:
@@ -79,6 +85,71 @@ bool TitleBarButton::event(QEvent *event) {
     return QPushButton::event(event);
 }
 
+void TitleBarButton::prerender(QIcon::Mode mode) {
+    if (this->m_role != Role::Tool || this->icon().isNull()) {
+        return;
+    }
+    auto *titleBar = static_cast<TitleBar *>(this->parent());
+    titleBar->toolIconCache().pixmap(this->icon(),
+                                     mode,
+                                     this->toolIconRect(),
+                                     this->size(),
+                                     this->devicePixelRatioF());
+}
+
+QRect TitleBarButton::toolIconRect() const {
+    QRect iconRect(0, 0, this->width() - 12, this->height() - 12);
+    iconRect.moveCenter(this->rect().center());
+    return iconRect;
+}
+
+void TitleBarButton::paintCaption(QPainter &painter,
+                                  const TitleBar &titleBar,
+                                  const CaptionPaint &button) {
+    const bool isMacCaptionStyle =
+        titleBar.captionButtonStyle() == CaptionButtonStyle::mac;
+
+    auto hoverColor = button.role == Role::Close ? QColor(232, 17, 35, 229)
+                                                 : button.hoverColor;
+    hoverColor.setAlpha(static_cast<int>(button.fader * hoverColor.alpha()));
+    if (!button.enabled || isMacCaptionStyle) {
+        hoverColor.setAlpha(0);
+    }
+
+    // On mac style, all caption buttons get the 'hovered' style if any of them
+    // is hovered - this mimics real macOS
+    const bool isHovered =
+        button.underMouse ||
+        (isMacCaptionStyle && titleBar.isCaptionButtonHovered());
+
+    // The glyphs are blitted from the shared pixmap cache instead of going
+    // through the style's icon path
+    const QPixmap pixmap = Internal::IconCache::instance().captionButtonPixmap(
+        titleBar.captionButtonStyle(),
+        titleBar.isActive(),
+        titleBar.isMaximized(),
+        isHovered,
+        isHovered && button.down,
+        button.role,
+        titleBar.captionGlyphColors(),
+        button.iconSize,
+        button.devicePixelRatio);
+
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QBrush(hoverColor));
+    painter.drawRect(button.rect);
+
+    if (!pixmap.isNull()) {
+        QRect iconRect(QPoint(0, 0), button.iconSize);
+        iconRect.moveCenter(button.rect.center());
+        if (button.down) {
+            iconRect.translate(button.pressedOffset);
+        }
+        painter.drawPixmap(iconRect, pixmap);
+    }
+}
+
 void TitleBarButton::paintEvent([[maybe_unused]] QPaintEvent *event) {
     auto *titleBar = static_cast<TitleBar *>(this->parent());
 
@@ -87,71 +158,41 @@ void TitleBarButton::paintEvent([[maybe_unused]] QPaintEvent *event) {
     styleOptionButton.initFrom(this);
     styleOptionButton.features = QStyleOptionButton::None;
     styleOptionButton.text = this->text();
-    styleOptionButton.icon =
-        this->m_role == Role::Tool ? QIcon() : this->icon();
+    styleOptionButton.icon = QIcon();
     styleOptionButton.iconSize = this->iconSize();
 
-    const auto hoverColor = [titleBar, this]() -> QColor {
-        auto col = this->m_role == Role::Close ? QColor(232, 17, 35, 229)
-                                               : this->m_hoverColor;
-        if (!this->m_keepDown) {
-            col.setAlpha(static_cast<int>(this->m_fader * col.alpha()));
-        }
-
-        bool isMacCaptionStyle =
-            titleBar->captionButtonStyle() == CaptionButtonStyle::mac;
-        bool isMacCaptionButton =
-            (isMacCaptionStyle && this->m_role == Role::Minimize) ||
-            (isMacCaptionStyle && this->m_role == Role::MaximizeRestore) ||
-            (isMacCaptionStyle && this->m_role == Role::Close);
-
-        if (!this->isEnabled() || this->m_role == Role::CaptionIcon ||
-            isMacCaptionButton) {
-            col.setAlpha(0);
-        }
-
-        return col;
-    }();
-
-    // On mac style, all caption buttons get the 'hovered' style if any of them
-    // is hovered - this mimics real macOS
-    const bool isHovered =
-        (styleOptionButton.state & QStyle::State_MouseOver) ||
-        (titleBar->captionButtonStyle() == CaptionButtonStyle::mac &&
-         titleBar->isCaptionButtonHovered());
-
-    const auto iconPaths =
-        Internal::captionIconPathsForState(titleBar->isActive(),
-                                           titleBar->isMaximized(),
-                                           isHovered,
-                                           this->isDown(),
-                                           titleBar->captionButtonStyle());
-
-    switch (this->m_role) {
-    case Role::CaptionIcon: {
-        break;
+    if (this->m_role != Role::Tool) {
+        paintCaption(
+            stylePainter,
+            *titleBar,
+            CaptionPaint{this->m_role,
+                         styleOptionButton.rect,
+                         this->iconSize(),
+                         QPoint(this->style()->pixelMetric(
+                                    QStyle::PM_ButtonShiftHorizontal,
+                                    &styleOptionButton,
+                                    this),
+                                this->style()->pixelMetric(
+                                    QStyle::PM_ButtonShiftVertical,
+                                    &styleOptionButton,
+                                    this)),
+                         this->m_hoverColor,
+                         this->fader(),
+                         this->isEnabled(),
+                         static_cast<bool>(styleOptionButton.state &
+                                           QStyle::State_MouseOver),
+                         this->isDown(),
+                         this->devicePixelRatioF()});
+        return;
     }
-    case Role::Minimize: {
-        if (isHovered) {
-            styleOptionButton.icon = QIcon(iconPaths[0].toString());
-        }
-        break;
-    }
-    case Role::MaximizeRestore: {
-        if (isHovered) {
-            styleOptionButton.icon = QIcon(iconPaths[1].toString());
-        }
-        break;
-    }
-    case Role::Close: {
-        if (isHovered) {
-            styleOptionButton.icon = QIcon(iconPaths[2].toString());
-        }
-        break;
-    }
-    case Role::Tool: {
-        break;
+
+    auto hoverColor = this->m_hoverColor;
+    if (!this->m_keepDown) {
+        hoverColor.setAlpha(
+            static_cast<int>(this->fader() * hoverColor.alpha()));
     }
+    if (!this->isEnabled()) {
+        hoverColor.setAlpha(0);
     }
 
     stylePainter.setRenderHint(QPainter::Antialiasing, false);
@@ -160,35 +201,37 @@ void TitleBarButton::paintEvent([[maybe_unused]] QPaintEvent *event) {
     stylePainter.drawRect(styleOptionButton.rect);
     stylePainter.drawControl(QStyle::CE_PushButtonLabel, styleOptionButton);
 
-    if (this->m_role == Role::Tool) {
-        const QIcon::Mode iconMode =
-            this->isEnabled()
-                ? ((this->m_keepDown) ? QIcon::Active : QIcon::Normal)
-                : QIcon::Disabled;
-        QRect iconRect(0, 0, this->width() - 12, this->height() - 12);
-        iconRect.moveCenter(this->rect().center());
-        Utils::StyleHelper::drawIconWithShadow(
-            this->icon(), iconRect, &stylePainter, iconMode);
-
-        if (this->m_keepDown) {
-            stylePainter.setOpacity(1.0);
-            QRect accentRect = this->rect();
-            accentRect.setHeight(1);
-            stylePainter.fillRect(
-                accentRect,
-                Utils::creatorTheme()->color(Utils::Theme::IconsBaseColor));
-        }
+    const QIcon::Mode iconMode =
+        this->isEnabled()
+            ? ((this->m_keepDown) ? QIcon::Active : QIcon::Normal)
+            : QIcon::Disabled;
+    stylePainter.drawPixmap(
+        0,
+        0,
+        titleBar->toolIconCache().pixmap(this->icon(),
+                                         iconMode,
+                                         this->toolIconRect(),
+                                         this->size(),
+                                         this->devicePixelRatioF()));
+
+    if (this->m_keepDown) {
+        stylePainter.setOpacity(1.0);
+        QRect accentRect = this->rect();
+        accentRect.setHeight(1);
+        stylePainter.fillRect(
+            accentRect,
+            Utils::creatorTheme()->color(Utils::Theme::IconsBaseColor));
     }
 }
 
 void TitleBarButton::enterEvent(QEvent *event) {
     QPushButton::enterEvent(event);
-    static_cast<TitleBar *>(this->parent())->triggerCaptionRepaint();
+    static_cast<TitleBar *>(this->parent())->onButtonHoverChanged(this);
 }
 
 void TitleBarButton::leaveEvent(QEvent *event) {
     QPushButton::leaveEvent(event);
-    static_cast<TitleBar *>(this->parent())->triggerCaptionRepaint();
+    static_cast<TitleBar *>(this->parent())->onButtonHoverChanged(this);
 }
 
 } // namespace CSD
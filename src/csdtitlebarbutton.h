@@ -2,19 +2,41 @@
 
 #include <QPushButton>
 
+#include <cstddef>
+
+class QPainter;
+
 namespace CSD {
 
 class TitleBar;
 
+namespace Internal {
+class FadeAnimator;
+}
+
 class TitleBarButton : public QPushButton {
     Q_OBJECT
     Q_PROPERTY(double fader READ fader WRITE setFader)
     Q_PROPERTY(bool keepDown READ keepDown WRITE setKeepDown)
 
 public:
-    enum Role { CaptionIcon, Minimize, MaximizeRestore, Close, Tool };
+    enum Role { Minimize, MaximizeRestore, Close, Tool };
     Q_ENUM(Role)
 
+    // What paintCaption() needs to know about one caption button
+    struct CaptionPaint {
+        Role role;
+        QRect rect;
+        QSize iconSize;
+        QPoint pressedOffset;
+        QColor hoverColor;
+        double fader;
+        bool enabled;
+        bool underMouse;
+        bool down;
+        qreal devicePixelRatio;
+    };
+
     explicit TitleBarButton(Role role, TitleBar *parent = nullptr);
     explicit TitleBarButton(const QString &text,
                             Role role,
@@ -30,6 +52,15 @@ public:
     void setHoverColor(QColor hoverColor);
     bool keepDown() const;
     void setKeepDown(bool keepDown);
+    // Renders the tool icon of mode into the title bar's cache ahead of
+    // the first paint event that needs it
+    void prerender(QIcon::Mode mode);
+
+    // Paints a caption button of titleBar; shared by the caption button
+    // widgets and the flyweight rendering of TitleBar
+    static void paintCaption(QPainter &painter,
+                             const TitleBar &titleBar,
+                             const CaptionPaint &button);
 
 protected:
     bool event(QEvent *event) override;
@@ -38,8 +69,11 @@ protected:
     void leaveEvent(QEvent *event) override;
 
 private:
+    QRect toolIconRect() const;
+
     Role m_role;
-    double m_fader = 0.0;
+    Internal::FadeAnimator *m_fadeAnimator = nullptr;
+    std::size_t m_fadeSlot = 0;
     QColor m_hoverColor = QColor(62, 68, 81);
     bool m_keepDown = false;
 };
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "captionbuttonstyle.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CSD::Internal {
+
+// Everything that decides how the caption buttons of a title bar look,
+// packed into one byte: bit 0 = active, bit 1 = maximized, bit 2 = any
+// caption button hovered and bits 3-4 = caption button style
+class VisualState {
+public:
+    constexpr VisualState() = default;
+    constexpr VisualState(CaptionButtonStyle style,
+                          bool active,
+                          bool maximized,
+                          bool captionHovered)
+        : m_bits(static_cast<std::uint8_t>(
+              (static_cast<unsigned int>(style) << styleShift) |
+              (active ? activeBit : 0u) | (maximized ? maximizedBit : 0u) |
+              (captionHovered ? captionHoveredBit : 0u))) {}
+
+    constexpr CaptionButtonStyle style() const {
+        return static_cast<CaptionButtonStyle>(this->m_bits >> styleShift);
+    }
+    constexpr bool isActive() const {
+        return this->m_bits & activeBit;
+    }
+    constexpr bool isMaximized() const {
+        return this->m_bits & maximizedBit;
+    }
+    constexpr bool isCaptionHovered() const {
+        return this->m_bits & captionHoveredBit;
+    }
+
+    constexpr VisualState withStyle(CaptionButtonStyle style) const {
+        return VisualState(style,
+                           this->isActive(),
+                           this->isMaximized(),
+                           this->isCaptionHovered());
+    }
+    constexpr VisualState withActive(bool active) const {
+        return VisualState(this->style(),
+                           active,
+                           this->isMaximized(),
+                           this->isCaptionHovered());
+    }
+    constexpr VisualState withMaximized(bool maximized) const {
+        return VisualState(this->style(),
+                           this->isActive(),
+                           maximized,
+                           this->isCaptionHovered());
+    }
+    constexpr VisualState withCaptionHovered(bool captionHovered) const {
+        return VisualState(this->style(),
+                           this->isActive(),
+                           this->isMaximized(),
+                           captionHovered);
+    }
+
+    constexpr std::uint8_t bits() const {
+        return this->m_bits;
+    }
+    constexpr bool operator==(VisualState other) const {
+        return this->m_bits == other.m_bits;
+    }
+    constexpr bool operator!=(VisualState other) const {
+        return this->m_bits != other.m_bits;
+    }
+
+private:
+    constexpr static unsigned int activeBit = 1u << 0;
+    constexpr static unsigned int maximizedBit = 1u << 1;
+    constexpr static unsigned int captionHoveredBit = 1u << 2;
+    constexpr static unsigned int styleShift = 3;
+
+    std::uint8_t m_bits = 0;
+};
+
+// Number of state changes a title bar was asked to apply and number of widget
+// repaints it issued for them
+struct RepaintCounters {
+    std::size_t events = 0;
+    std::size_t repaints = 0;
+};
+
+// Number of activation and window state notifications a title bar received
+// and number of state updates it applied after merging them
+struct WindowEventCounters {
+    std::size_t received = 0;
+    std::size_t applied = 0;
+};
+
+} // namespace CSD::Internal
@@ -0,0 +1,45 @@
+#include "csdwindowwatcher.h"
+
+#include <QApplication>
+#include <QWidget>
+#include <QWindow>
+
+namespace CSD::Internal {
+
+WindowWatcher::WindowWatcher(QObject *parent) : QObject(parent) {
+    QObject::connect(qApp,
+                     &QGuiApplication::focusWindowChanged,
+                     this,
+                     &WindowWatcher::onFocusWindowChanged);
+}
+
+std::size_t WindowWatcher::reportedWindows() const {
+    return this->m_reported.size();
+}
+
+void WindowWatcher::onFocusWindowChanged(QWindow *focusWindow) {
+    if (focusWindow == nullptr) {
+        return;
+    }
+    const auto topLevelWidgets = QApplication::topLevelWidgets();
+    for (QWidget *window : topLevelWidgets) {
+        if (window->windowHandle() != focusWindow) {
+            continue;
+        }
+        const Qt::WindowType type = window->windowType();
+        if ((type != Qt::Window && type != Qt::Tool) ||
+            !this->m_reported.insert(window).second) {
+            return;
+        }
+        QObject::connect(window,
+                         &QObject::destroyed,
+                         this,
+                         [this](QObject *object) {
+                             this->m_reported.erase(object);
+                         });
+        emit this->windowActivated(window);
+        return;
+    }
+}
+
+} // namespace CSD::Internal
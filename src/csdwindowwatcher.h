@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QObject>
+
+#include <cstddef>
+#include <unordered_set>
+
+class QWidget;
+class QWindow;
+
+namespace CSD::Internal {
+
+// Reports top-level widgets that may get a title bar: normal windows and tool
+// windows, like floating panes and detached views. Instead of filtering all
+// events of the application, it only follows focus window changes, so each
+// window is reported once, the first time it becomes active. Destroyed
+// windows are forgotten.
+class WindowWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit WindowWatcher(QObject *parent = nullptr);
+    ~WindowWatcher() override = default;
+
+    std::size_t reportedWindows() const;
+
+signals:
+    void windowActivated(QWidget *window);
+
+private:
+    void onFocusWindowChanged(QWindow *focusWindow);
+
+    std::unordered_set<const QObject *> m_reported;
+};
+
+} // namespace CSD::Internal
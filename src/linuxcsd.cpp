@@ -1,11 +1,88 @@
 #include "linuxcsd.h"
 
+#include "x11moveresize.h"
+
 #include <QEvent>
+#include <QGuiApplication>
+#include <QMouseEvent>
 #include <QWidget>
+#include <QWindow>
+
+#include <QX11Info>
+
+#include <private/qhighdpiscaling_p.h>
 
 namespace CSD::Internal {
 
-LinuxClientSideDecorationFilter::WidgetCallbacks::WidgetCallbacks(
+constexpr static int resizeBorderWidth = 6;
+
+constexpr static EventTypeSet widgetEventTypes = {QEvent::ActivationChange,
+                                                  QEvent::WindowStateChange,
+                                                  QEvent::WinIdChange,
+                                                  QEvent::Show};
+
+constexpr static EventTypeSet windowEventTypes = {
+    QEvent::MouseMove, QEvent::MouseButtonPress, QEvent::Leave};
+
+static Qt::CursorShape cursorShapeForZone(ResizeZone resizeZone) {
+    switch (resizeZone) {
+    case ResizeZone::Left:
+    case ResizeZone::Right: {
+        return Qt::SizeHorCursor;
+    }
+    case ResizeZone::Top:
+    case ResizeZone::Bottom: {
+        return Qt::SizeVerCursor;
+    }
+    case ResizeZone::TopLeft:
+    case ResizeZone::BottomRight: {
+        return Qt::SizeFDiagCursor;
+    }
+    case ResizeZone::TopRight:
+    case ResizeZone::BottomLeft: {
+        return Qt::SizeBDiagCursor;
+    }
+    case ResizeZone::None: {
+        break;
+    }
+    }
+    return Qt::ArrowCursor;
+}
+
+static X11MoveResize::Direction directionForZone(ResizeZone resizeZone) {
+    switch (resizeZone) {
+    case ResizeZone::Left: {
+        return X11MoveResize::SizeLeft;
+    }
+    case ResizeZone::Right: {
+        return X11MoveResize::SizeRight;
+    }
+    case ResizeZone::Top: {
+        return X11MoveResize::SizeTop;
+    }
+    case ResizeZone::Bottom: {
+        return X11MoveResize::SizeBottom;
+    }
+    case ResizeZone::TopLeft: {
+        return X11MoveResize::SizeTopLeft;
+    }
+    case ResizeZone::TopRight: {
+        return X11MoveResize::SizeTopRight;
+    }
+    case ResizeZone::BottomLeft: {
+        return X11MoveResize::SizeBottomLeft;
+    }
+    case ResizeZone::BottomRight: {
+        return X11MoveResize::SizeBottomRight;
+    }
+    case ResizeZone::None: {
+        break;
+    }
+    }
+    return X11MoveResize::Move;
+}
+
+LinuxClientSideDecorationFilter::WindowData::WindowData(
     Callback onActivationChanged, Callback onWindowStateChanged)
     : onActivationChanged(std::move(onActivationChanged)),
       onWindowStateChanged(std::move(onWindowStateChanged)) {}
@@ -15,20 +92,46 @@ LinuxClientSideDecorationFilter::LinuxClientSideDecorationFilter(
     : QObject(parent) {}
 
 LinuxClientSideDecorationFilter::~LinuxClientSideDecorationFilter() {
-    for (const auto &pair : this->m_callbacks) {
-        pair.first->removeEventFilter(this);
+    this->m_registry.forEach([this](Registry::Entry &entry) {
+        entry.widget->removeEventFilter(this);
+        if (QWindow *window = entry.widget->windowHandle()) {
+            window->removeEventFilter(this);
+        }
+    });
+    if (this->m_overrideCursorSet) {
+        QGuiApplication::restoreOverrideCursor();
     }
 }
 
 bool LinuxClientSideDecorationFilter::eventFilter(QObject *watched,
                                                   QEvent *event) {
-    QWidget *widget = static_cast<QWidget *>(watched);
-    auto resultIterator = this->m_callbacks.find(widget);
+    const QEvent::Type type = event->type();
+    if (watched->isWindowType()) {
+        if (!windowEventTypes.contains(type)) {
+            return false;
+        }
+        return this->windowEventFilter(static_cast<QWindow *>(watched),
+                                       event);
+    }
+    if (!widgetEventTypes.contains(type)) {
+        return false;
+    }
+
+    Registry::Entry *entry = this->m_registry.find(watched);
+    if (entry == nullptr) {
+        return false;
+    }
 
-    if (event->type() == QEvent::ActivationChange) {
-        resultIterator->second.onActivationChanged();
-    } else if (event->type() == QEvent::WindowStateChange) {
-        resultIterator->second.onWindowStateChanged();
+    if (type == QEvent::ActivationChange) {
+        entry->data.onActivationChanged();
+    } else if (type == QEvent::WindowStateChange) {
+        entry->data.onWindowStateChanged();
+    } else if (type == QEvent::WinIdChange) {
+        this->m_registry.updateHandle(entry->widget);
+        entry->data.isWindowWatched = false;
+        this->watchWindow(*entry);
+    } else if (type == QEvent::Show) {
+        this->watchWindow(*entry);
     }
 
     return false;
@@ -37,12 +140,109 @@ bool LinuxClientSideDecorationFilter::eventFilter(QObject *watched,
 void LinuxClientSideDecorationFilter::apply(QWidget *widget,
                                             Callback onActivationChanged,
                                             Callback onWindowStateChanged) {
-    this->m_callbacks.emplace(
+    Registry::Entry &entry = this->m_registry.add(
         widget,
-        WidgetCallbacks(std::move(onActivationChanged),
-                        std::move(onWindowStateChanged)));
+        WindowData(std::move(onActivationChanged),
+                   std::move(onWindowStateChanged)),
+        this);
     widget->installEventFilter(this);
+    // Changing the window flags hides a window that is already shown
+    const bool wasVisible = widget->isVisible();
     widget->setWindowFlag(Qt::FramelessWindowHint);
+    if (wasVisible) {
+        widget->show();
+    }
+    X11MoveResize::instance().prefetch();
+    this->watchWindow(entry);
+}
+
+void LinuxClientSideDecorationFilter::watchWindow(Registry::Entry &entry) {
+    // Mouse events reach the QWindow before they are dispatched to child
+    // widgets, so the resize borders work on top of any child
+    QWindow *window = entry.widget->windowHandle();
+    if (window == nullptr || entry.data.isWindowWatched ||
+        !QX11Info::isPlatformX11()) {
+        return;
+    }
+    entry.data.isWindowWatched = true;
+    window->installEventFilter(this);
+}
+
+bool LinuxClientSideDecorationFilter::windowEventFilter(QWindow *window,
+                                                        QEvent *event) {
+    Registry::Entry *entry = this->m_registry.findByHandle(window->winId());
+    if (entry == nullptr) {
+        return false;
+    }
+    WindowData &data = entry->data;
+    const QEvent::Type type = event->type();
+
+    if (type == QEvent::Leave) {
+        this->setResizeZone(data, ResizeZone::None);
+        return false;
+    }
+
+    auto *mouseEvent = static_cast<QMouseEvent *>(event);
+    const QWidget *widget = entry->widget;
+    const bool resizable =
+        !(widget->windowState() &
+          (Qt::WindowMaximized | Qt::WindowFullScreen)) &&
+        mouseEvent->buttons() == (type == QEvent::MouseButtonPress
+                                      ? mouseEvent->button()
+                                      : Qt::NoButton);
+    const ResizeZone resizeZone =
+        resizable ? resizeZoneAt(QRect(QPoint(0, 0), window->size()),
+                                 mouseEvent->localPos().toPoint(),
+                                 resizeBorderWidth,
+                                 widget->minimumWidth() !=
+                                     widget->maximumWidth(),
+                                 widget->minimumHeight() !=
+                                     widget->maximumHeight())
+                  : ResizeZone::None;
+
+    if (type == QEvent::MouseMove) {
+        this->setResizeZone(data, resizeZone);
+        return false;
+    }
+
+    if (mouseEvent->button() != Qt::LeftButton ||
+        resizeZone == ResizeZone::None) {
+        return false;
+    }
+
+    const QPoint globalPos = QHighDpi::toNativePixels(
+        mouseEvent->screenPos().toPoint(), window);
+    this->setResizeZone(data, ResizeZone::None);
+    return X11MoveResize::instance().start(
+        static_cast<xcb_window_t>(window->winId()),
+        window->screen(),
+        globalPos,
+        directionForZone(resizeZone));
+}
+
+void LinuxClientSideDecorationFilter::setResizeZone(WindowData &data,
+                                                    ResizeZone resizeZone) {
+    // Only touch the cursor on zone transitions
+    if (data.resizeZone == resizeZone) {
+        return;
+    }
+    data.resizeZone = resizeZone;
+
+    if (resizeZone == ResizeZone::None) {
+        if (this->m_overrideCursorSet) {
+            QGuiApplication::restoreOverrideCursor();
+            this->m_overrideCursorSet = false;
+        }
+        return;
+    }
+
+    const auto cursor = QCursor(cursorShapeForZone(resizeZone));
+    if (this->m_overrideCursorSet) {
+        QGuiApplication::changeOverrideCursor(cursor);
+    } else {
+        QGuiApplication::setOverrideCursor(cursor);
+        this->m_overrideCursorSet = true;
+    }
 }
 
 } // namespace CSD::Internal
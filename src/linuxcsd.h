@@ -1,9 +1,13 @@
 #pragma once
 
+#include "csddecorationregistry.h"
+#include "csdresizezone.h"
+
 #include <QObject>
 
 #include <functional>
-#include <unordered_map>
+
+class QWindow;
 
 namespace CSD::Internal {
 
@@ -12,13 +16,21 @@ class LinuxClientSideDecorationFilter : public QObject {
 
 private:
     using Callback = std::function<void()>;
-    struct WidgetCallbacks {
+    struct WindowData {
         Callback onActivationChanged;
         Callback onWindowStateChanged;
-        WidgetCallbacks(Callback onActivationChanged,
-                        Callback onWindowStateChanged);
+        bool isWindowWatched = false;
+        ResizeZone resizeZone = ResizeZone::None;
+        WindowData(Callback onActivationChanged,
+                   Callback onWindowStateChanged);
     };
-    std::unordered_map<QWidget *, WidgetCallbacks> m_callbacks;
+    using Registry = DecorationRegistry<WindowData>;
+    Registry m_registry;
+    bool m_overrideCursorSet = false;
+
+    void watchWindow(Registry::Entry &entry);
+    bool windowEventFilter(QWindow *window, QEvent *event);
+    void setResizeZone(WindowData &data, ResizeZone resizeZone);
 
 public:
     explicit LinuxClientSideDecorationFilter(QObject *parent = nullptr);
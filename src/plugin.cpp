@@ -1,17 +1,24 @@
 #include "plugin.h"
 
+#include "csdiconcache.h"
+#include "csdstyleresources.h"
 #include "csdtitlebar.h"
 #include "csdtitlebarbutton.h"
+#include "csdwindowwatcher.h"
 #include "optionspage.h"
 
 #include <coreplugin/coreicons.h>
 #include <coreplugin/icore.h>
+#include <extensionsystem/pluginspec.h>
 
 #include <utils/theme/theme.h>
 
 #include <QApplication>
 #include <QBoxLayout>
+#include <QMainWindow>
 #include <QMenuBar>
+#include <QPointer>
+#include <QTimer>
 
 inline void init_resource() {
     Q_INIT_RESOURCE(csd);
@@ -30,52 +37,55 @@ CSDPlugin::CSDPlugin() noexcept {
 #endif
 }
 
+CSDPlugin::~CSDPlugin() noexcept = default;
+
 bool CSDPlugin::initialize([[maybe_unused]] const QStringList &arguments,
                            [[maybe_unused]] QString *errorString) {
     this->m_settings.load(Core::ICore::settings());
 
+    // Only the caption glyphs of the selected style are mapped
+    this->m_styleResources =
+        std::make_unique<StyleResources>(this->pluginSpec()->location());
+    this->m_styleResources->activate(this->m_settings.captionButtonStyle);
+
     QMainWindow *mainWindow = Core::ICore::mainWindow();
     auto wrapperLayout =
         static_cast<QVBoxLayout *>(mainWindow->centralWidget()->layout());
 
+    // Only the skeleton is built on the startup path; the tool and mode
+    // buttons follow in delayedInitialize()
     this->m_titleBar = new TitleBar(this->m_settings.captionButtonStyle,
                                     Core::Icons::QTCREATORLOGO_BIG.icon(),
-                                    mainWindow->centralWidget());
+                                    mainWindow->centralWidget(),
+                                    TitleBar::Controls::CaptionOnly);
     this->m_titleBar->setHoverColor(
         Utils::creatorTheme()->color(Utils::Theme::FancyToolButtonHoverColor));
     this->m_titleBar->setActiveColor(QColor(40, 44, 52));
     wrapperLayout->insertWidget(0, this->m_titleBar);
-
-    QObject::connect(
-        this->m_titleBar, &TitleBar::minimizeClicked, this, [mainWindow]() {
-            mainWindow->setWindowState(mainWindow->windowState() |
-                                       Qt::WindowMinimized);
-        });
-    QObject::connect(this->m_titleBar,
-                     &TitleBar::maximizeRestoreClicked,
+    this->attachTitleBar(mainWindow, this->m_titleBar);
+
+    // Other top-level windows, like editor windows opened with "Open in New
+    // Window", floating panes and detached views, get a title bar with
+    // caption buttons when first activated
+    this->m_windowWatcher = new WindowWatcher(this);
+    QObject::connect(this->m_windowWatcher,
+                     &WindowWatcher::windowActivated,
                      this,
-                     [mainWindow]() {
-                         mainWindow->setWindowState(mainWindow->windowState() ^
-                                                    Qt::WindowMaximized);
+                     [this](QWidget *window) {
+                         if (window == Core::ICore::mainWindow()) {
+                             return;
+                         }
+                         // Decorating changes the window flags, which must
+                         // not happen while the window is being activated
+                         QTimer::singleShot(
+                             0,
+                             this,
+                             [this, window = QPointer<QWidget>(window)]() {
+                                 if (!window.isNull()) {
+                                     this->decorateWindow(window);
+                                 }
+                             });
                      });
-    QObject::connect(this->m_titleBar,
-                     &TitleBar::closeClicked,
-                     mainWindow,
-                     &QWidget::close);
-
-    this->m_filter->apply(
-        mainWindow,
-#ifdef _WIN32
-        [this]() { return this->m_titleBar->hovered(); },
-#endif
-        [this]() {
-            const bool on = this->m_titleBar->window()->isActiveWindow();
-            this->m_titleBar->setActive(on);
-        },
-        [this]() {
-            this->m_titleBar->onWindowStateChange(
-                this->m_titleBar->window()->windowState());
-        });
 
     this->m_optionsPage = new OptionsPage(this->m_settings, this);
 
@@ -94,6 +104,12 @@ bool CSDPlugin::initialize([[maybe_unused]] const QStringList &arguments,
 }
 
 CSDPlugin::ShutdownFlag CSDPlugin::aboutToShutdown() {
+    delete this->m_windowWatcher;
+    this->m_windowWatcher = nullptr;
+    // Glyphs whose rasterization did not finish in time are written now;
+    // the pixmaps must be gone before QApplication is destroyed
+    IconCache::instance().saveDiskCaches();
+    IconCache::instance().shutDown();
 #ifdef _WIN32
     QCoreApplication::instance()->removeNativeEventFilter(this->m_filter);
 #endif
@@ -102,13 +118,76 @@ CSDPlugin::ShutdownFlag CSDPlugin::aboutToShutdown() {
 
 void CSDPlugin::extensionsInitialized() {}
 
+bool CSDPlugin::delayedInitialize() {
+    this->m_titleBar->createToolButtons();
+    return true;
+}
+
+void CSDPlugin::decorateWindow(QWidget *window) {
+    if (window->findChild<TitleBar *>(QString(),
+                                      Qt::FindDirectChildrenOnly) != nullptr) {
+        return;
+    }
+    auto *layout = qobject_cast<QBoxLayout *>(window->layout());
+    if (qobject_cast<QMainWindow *>(window) != nullptr || layout == nullptr ||
+        layout->direction() != QBoxLayout::TopToBottom) {
+        return;
+    }
+
+    // Caption glyphs and icons come from the process wide IconCache and the
+    // window is registered with the same filter as the main window. The
+    // caption buttons are painted by the title bar itself, so an additional
+    // window only costs the title bar widget.
+    auto *titleBar = new TitleBar(this->m_settings.captionButtonStyle,
+                                  Core::Icons::QTCREATORLOGO_BIG.icon(),
+                                  window,
+                                  TitleBar::Controls::CaptionOnly,
+                                  TitleBar::Rendering::Flyweight);
+    titleBar->setHoverColor(
+        Utils::creatorTheme()->color(Utils::Theme::FancyToolButtonHoverColor));
+    titleBar->setActiveColor(this->m_titleBar->activeColor());
+    layout->insertWidget(0, titleBar);
+    this->attachTitleBar(window, titleBar);
+}
+
+void CSDPlugin::attachTitleBar(QWidget *window, TitleBar *titleBar) {
+    QObject::connect(
+        titleBar, &TitleBar::minimizeClicked, window, [window]() {
+            window->setWindowState(window->windowState() |
+                                   Qt::WindowMinimized);
+        });
+    QObject::connect(
+        titleBar, &TitleBar::maximizeRestoreClicked, window, [window]() {
+            window->setWindowState(window->windowState() ^
+                                   Qt::WindowMaximized);
+        });
+    QObject::connect(
+        titleBar, &TitleBar::closeClicked, window, &QWidget::close);
+
+    this->m_filter->apply(
+        window,
+#ifdef _WIN32
+        [titleBar](const QPoint &globalPos) {
+            return titleBar->isCaptionAt(titleBar->mapFromGlobal(globalPos));
+        },
+#endif
+        [titleBar]() { titleBar->scheduleWindowStateSync(); },
+        [titleBar]() { titleBar->scheduleWindowStateSync(); });
+}
+
 void CSDPlugin::settingsChanged(const Settings &settings) {
     settings.save(Core::ICore::settings());
     this->m_settings = settings;
     this->m_optionsPage->setSettings(this->m_settings);
-    this->m_titleBar->setCaptionButtonStyle(
-        this->m_settings.captionButtonStyle);
-    this->m_titleBar->triggerCaptionRepaint();
+    this->m_styleResources->activate(this->m_settings.captionButtonStyle);
+    const auto topLevelWidgets = QApplication::topLevelWidgets();
+    for (const QWidget *topLevelWidget : topLevelWidgets) {
+        const auto titleBars = topLevelWidget->findChildren<TitleBar *>();
+        for (TitleBar *titleBar : titleBars) {
+            titleBar->setCaptionButtonStyle(
+                this->m_settings.captionButtonStyle);
+        }
+    }
 }
 
 } // namespace CSD::Internal
@@ -6,6 +6,8 @@
 
 #include <QStringList>
 
+#include <memory>
+
 #ifdef _WIN32
 #include "win32csd.h"
 #elif defined(__APPLE__)
@@ -21,6 +23,8 @@ class TitleBarButton;
 namespace Internal {
 
 class OptionsPage;
+class StyleResources;
+class WindowWatcher;
 
 class CSDPlugin final : public ExtensionSystem::IPlugin {
     Q_OBJECT
@@ -28,10 +32,11 @@ class CSDPlugin final : public ExtensionSystem::IPlugin {
 
 public:
     CSDPlugin() noexcept;
-    ~CSDPlugin() noexcept override = default;
+    ~CSDPlugin() noexcept override;
     bool initialize(const QStringList &arguments,
                     QString *errorString) override;
     void extensionsInitialized() override;
+    bool delayedInitialize() override;
     ShutdownFlag aboutToShutdown() override;
 
 private:
@@ -45,10 +50,14 @@ private:
     TitleBar *m_titleBar = nullptr;
 #endif
 
+    WindowWatcher *m_windowWatcher = nullptr;
     OptionsPage *m_optionsPage = nullptr;
     Settings m_settings;
+    std::unique_ptr<StyleResources> m_styleResources;
 
     void settingsChanged(const Settings &settings);
+    void decorateWindow(QWidget *window);
+    void attachTitleBar(QWidget *window, TitleBar *titleBar);
 };
 
 } // namespace Internal
@@ -1,20 +1,26 @@
 #include "win32csd.h"
 
+#include "csdresizezone.h"
+
 #include <QEvent>
 #include <QGuiApplication>
 #include <QWidget>
 #include <QWindow>
 
+#include <private/qhighdpiscaling_p.h>
 #include <qpa/qplatformnativeinterface.h>
 
 namespace CSD::Internal {
 
+constexpr static EventTypeSet widgetEventTypes = {QEvent::ActivationChange,
+                                                  QEvent::WindowStateChange,
+                                                  QEvent::WinIdChange};
+
 Win32ClientSideDecorationFilter::HWNDData::HWNDData(
-    QWidget *widget,
-    std::function<bool()> isCaptionHovered,
+    std::function<bool(const QPoint &)> isCaptionAt,
     std::function<void()> onActivationChanged,
     std::function<void()> onWindowStateChanged)
-    : widget(widget), isCaptionHovered(std::move(isCaptionHovered)),
+    : isCaptionAt(std::move(isCaptionAt)),
       onActivationChanged(std::move(onActivationChanged)),
       onWindowStateChanged(std::move(onWindowStateChanged)) {}
 
@@ -26,17 +32,22 @@ Win32ClientSideDecorationFilter::~Win32ClientSideDecorationFilter() = default;
 
 bool Win32ClientSideDecorationFilter::eventFilter(QObject *watched,
                                                   QEvent *event) {
-    auto resultIterator =
-        std::find_if(std::begin(this->appliedHWNDs),
-                     std::end(this->appliedHWNDs),
-                     [watched](const auto &hwndDataPair) {
-                         return hwndDataPair.second.widget == watched;
-                     });
-
-    if (event->type() == QEvent::ActivationChange) {
-        resultIterator->second.onActivationChanged();
-    } else if (event->type() == QEvent::WindowStateChange) {
-        resultIterator->second.onWindowStateChanged();
+    const QEvent::Type type = event->type();
+    if (!widgetEventTypes.contains(type)) {
+        return false;
+    }
+
+    Registry::Entry *entry = this->appliedHWNDs.find(watched);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    if (type == QEvent::ActivationChange) {
+        entry->data.onActivationChanged();
+    } else if (type == QEvent::WindowStateChange) {
+        entry->data.onWindowStateChanged();
+    } else if (type == QEvent::WinIdChange) {
+        this->appliedHWNDs.updateHandle(entry->widget);
     }
 
     return false;
@@ -51,8 +62,9 @@ bool Win32ClientSideDecorationFilter::nativeEventFilter(
         return false;
     }
 
-    auto resultIterator = this->appliedHWNDs.find(msg->hwnd);
-    if (resultIterator == std::end(this->appliedHWNDs)) {
+    Registry::Entry *entry =
+        this->appliedHWNDs.findByHandle(reinterpret_cast<WId>(msg->hwnd));
+    if (entry == nullptr) {
         return false;
     }
 
@@ -110,61 +122,68 @@ bool Win32ClientSideDecorationFilter::nativeEventFilter(
 
     if (msg->message == WM_NCHITTEST) {
         *result = 0;
-        const LONG borderWidth = 8;
+        const int borderWidth = 8;
         auto clientRect = ::RECT();
         ::GetWindowRect(msg->hwnd, &clientRect);
 
         auto x = GET_X_LPARAM(msg->lParam);
         auto y = GET_Y_LPARAM(msg->lParam);
 
-        auto resizeWidth = resultIterator->second.widget->minimumWidth() !=
-                           resultIterator->second.widget->maximumWidth();
-        auto resizeHeight = resultIterator->second.widget->minimumHeight() !=
-                            resultIterator->second.widget->maximumHeight();
-
-        if (resizeWidth) {
-            if (x >= clientRect.left && x < clientRect.left + borderWidth) {
-                *result = HTLEFT;
-            }
-            if (x < clientRect.right && x >= clientRect.right - borderWidth) {
-                *result = HTRIGHT;
-            }
+        auto resizeWidth =
+            entry->widget->minimumWidth() != entry->widget->maximumWidth();
+        auto resizeHeight =
+            entry->widget->minimumHeight() != entry->widget->maximumHeight();
+
+        const auto bounds = QRect(clientRect.left,
+                                  clientRect.top,
+                                  clientRect.right - clientRect.left,
+                                  clientRect.bottom - clientRect.top);
+        switch (resizeZoneAt(
+            bounds, QPoint(x, y), borderWidth, resizeWidth, resizeHeight)) {
+        case ResizeZone::None: {
+            break;
         }
-        if (resizeHeight) {
-            if (y < clientRect.bottom &&
-                y >= clientRect.bottom - borderWidth) {
-                *result = HTBOTTOM;
-            }
-            if (y >= clientRect.top && y < clientRect.top + borderWidth) {
-                *result = HTTOP;
-            }
+        case ResizeZone::Left: {
+            *result = HTLEFT;
+            break;
+        }
+        case ResizeZone::Right: {
+            *result = HTRIGHT;
+            break;
+        }
+        case ResizeZone::Top: {
+            *result = HTTOP;
+            break;
+        }
+        case ResizeZone::Bottom: {
+            *result = HTBOTTOM;
+            break;
+        }
+        case ResizeZone::TopLeft: {
+            *result = HTTOPLEFT;
+            break;
+        }
+        case ResizeZone::TopRight: {
+            *result = HTTOPRIGHT;
+            break;
+        }
+        case ResizeZone::BottomLeft: {
+            *result = HTBOTTOMLEFT;
+            break;
+        }
+        case ResizeZone::BottomRight: {
+            *result = HTBOTTOMRIGHT;
+            break;
         }
-        if (resizeWidth && resizeHeight) {
-            if (x >= clientRect.left && x < clientRect.left + borderWidth &&
-                y < clientRect.bottom &&
-                y >= clientRect.bottom - borderWidth) {
-                *result = HTBOTTOMLEFT;
-            }
-            if (x < clientRect.right && x >= clientRect.right - borderWidth &&
-                y < clientRect.bottom &&
-                y >= clientRect.bottom - borderWidth) {
-                *result = HTBOTTOMRIGHT;
-            }
-            if (x >= clientRect.left && x < clientRect.left + borderWidth &&
-                y >= clientRect.top && y < clientRect.top + borderWidth) {
-                *result = HTTOPLEFT;
-            }
-            if (x < clientRect.right && x >= clientRect.right - borderWidth &&
-                y >= clientRect.top && y < clientRect.top + borderWidth) {
-                *result = HTTOPRIGHT;
-            }
         }
 
         if (*result != 0) {
             return true;
         }
 
-        if (resultIterator->second.isCaptionHovered()) {
+        const QPoint globalPos = QHighDpi::fromNativePixels(
+            QPoint(x, y), entry->widget->windowHandle());
+        if (entry->data.isCaptionAt(globalPos)) {
             *result = HTCAPTION;
             return true;
         }
@@ -190,15 +209,28 @@ bool Win32ClientSideDecorationFilter::nativeEventFilter(
 
 void Win32ClientSideDecorationFilter::apply(
     QWidget *widget,
-    std::function<bool()> isCaptionHovered,
+    std::function<bool(const QPoint &)> isCaptionAt,
     std::function<void()> onActivationChanged,
     std::function<void()> onWindowStateChanged) {
-    this->appliedHWNDs.emplace(reinterpret_cast<HWND>(widget->winId()),
-                               HWNDData(widget,
-                                        std::move(isCaptionHovered),
-                                        std::move(onActivationChanged),
-                                        std::move(onWindowStateChanged)));
+    // The HWND has to exist before the first native event is filtered
+    auto hwnd = reinterpret_cast<HWND>(widget->winId());
+    this->appliedHWNDs.add(widget,
+                           HWNDData(std::move(isCaptionAt),
+                                    std::move(onActivationChanged),
+                                    std::move(onWindowStateChanged)),
+                           this);
     widget->installEventFilter(this);
+
+    // WM_CREATE has already been sent at this point, so the frame has to be
+    // recalculated explicitly
+    ::SetWindowPos(hwnd,
+                   nullptr,
+                   0,
+                   0,
+                   0,
+                   0,
+                   SWP_FRAMECHANGED | SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER |
+                       SWP_NOACTIVATE);
 }
 
 } // namespace CSD::Internal
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "csddecorationregistry.h"
+
 #include <Windows.h>
 #include <dwmapi.h>
 #include <windowsx.h>
@@ -8,9 +10,9 @@
 #include <QMargins>
 #include <QMetaType>
 #include <QObject>
+#include <QPoint>
 
 #include <functional>
-#include <unordered_map>
 
 Q_DECLARE_METATYPE(QMargins)
 
@@ -24,16 +26,15 @@ class Win32ClientSideDecorationFilter : public QObject,
 
 private:
     struct HWNDData {
-        QWidget *widget;
-        std::function<bool()> isCaptionHovered;
+        std::function<bool(const QPoint &)> isCaptionAt;
         std::function<void()> onActivationChanged;
         std::function<void()> onWindowStateChanged;
-        HWNDData(QWidget *widget,
-                 std::function<bool()> isCaptionHovered,
+        HWNDData(std::function<bool(const QPoint &)> isCaptionAt,
                  std::function<void()> onActivationChanged,
                  std::function<void()> onWindowStateChanged);
     };
-    std::unordered_map<HWND, HWNDData> appliedHWNDs;
+    using Registry = DecorationRegistry<HWNDData>;
+    Registry appliedHWNDs;
 
 public:
     explicit Win32ClientSideDecorationFilter(QObject *parent = nullptr);
@@ -44,7 +45,7 @@ public:
                            void *message,
                            long *result) override;
     void apply(QWidget *widget,
-               std::function<bool()> isCaptionHovered,
+               std::function<bool(const QPoint &)> isCaptionAt,
                std::function<void()> onActivationChanged,
                std::function<void()> onWindowStateChanged);
 };
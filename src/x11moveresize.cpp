@@ -0,0 +1,137 @@
+#include "x11moveresize.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+#include <QTimer>
+
+#include <QX11Info>
+#include <qpa/qplatformnativeinterface.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace CSD::Internal {
+
+constexpr static const char _NET_WM_MOVERESIZE[] = "_NET_WM_MOVERESIZE";
+
+X11MoveResize &X11MoveResize::instance() {
+    static X11MoveResize moveResize;
+    return moveResize;
+}
+
+void X11MoveResize::prefetch() {
+    if (this->m_prefetched || !QX11Info::isPlatformX11()) {
+        return;
+    }
+    this->m_prefetched = true;
+
+    this->m_atomCookie = xcb_intern_atom(
+        QX11Info::connection(),
+        false,
+        static_cast<std::uint16_t>(std::strlen(_NET_WM_MOVERESIZE)),
+        _NET_WM_MOVERESIZE);
+    this->m_atomPending = true;
+    xcb_flush(QX11Info::connection());
+
+    // Collect the reply once the event loop runs again; by then it has
+    // almost certainly arrived and reading it does not block
+    QTimer::singleShot(0, qGuiApp, [this]() { this->moveResizeAtom(); });
+
+    // Screens on different X screens have different root windows
+    const auto screens = QGuiApplication::screens();
+    for (const QScreen *screen : screens) {
+        this->addScreen(screen);
+    }
+    QObject::connect(qGuiApp,
+                     &QGuiApplication::screenAdded,
+                     qGuiApp,
+                     [this](QScreen *screen) { this->addScreen(screen); });
+    QObject::connect(qGuiApp,
+                     &QGuiApplication::screenRemoved,
+                     qGuiApp,
+                     [this](QScreen *screen) {
+                         this->m_rootWindows.erase(screen);
+                     });
+}
+
+void X11MoveResize::addScreen(const QScreen *screen) {
+    // The xcb platform plugin knows the root of each screen from the
+    // connection setup, no round trip involved
+    void *root = QGuiApplication::platformNativeInterface()
+                     ->nativeResourceForScreen(QByteArrayLiteral("rootwindow"),
+                                               const_cast<QScreen *>(screen));
+    this->m_rootWindows[screen] =
+        root != nullptr
+            ? static_cast<xcb_window_t>(reinterpret_cast<quintptr>(root))
+            : static_cast<xcb_window_t>(
+                  QX11Info::appRootWindow(QX11Info::appScreen()));
+}
+
+xcb_window_t X11MoveResize::rootWindow(const QScreen *screen) const {
+    auto resultIterator = this->m_rootWindows.find(screen);
+    if (resultIterator == std::end(this->m_rootWindows)) {
+        return XCB_WINDOW_NONE;
+    }
+    return resultIterator->second;
+}
+
+xcb_atom_t X11MoveResize::moveResizeAtom() {
+    if (this->m_atomPending) {
+        this->m_atomPending = false;
+        xcb_intern_atom_reply_t *reply = xcb_intern_atom_reply(
+            QX11Info::connection(), this->m_atomCookie, nullptr);
+        if (reply != nullptr) {
+            this->m_moveResizeAtom = reply->atom;
+            std::free(reply);
+        }
+    }
+    return this->m_moveResizeAtom;
+}
+
+bool X11MoveResize::start(xcb_window_t window,
+                          const QScreen *screen,
+                          const QPoint &nativeGlobalPos,
+                          Direction direction) {
+    this->prefetch();
+    const xcb_atom_t atom = this->moveResizeAtom();
+    const xcb_window_t root = this->rootWindow(screen);
+    if (atom == XCB_ATOM_NONE || root == XCB_WINDOW_NONE) {
+        return false;
+    }
+
+    xcb_client_message_event_t xev;
+    std::memset(&xev, 0, sizeof(xev));
+    xev.response_type = XCB_CLIENT_MESSAGE;
+    xev.type = atom;
+    xev.sequence = 0;
+    xev.window = window;
+    xev.format = 32;
+    xev.data.data32[0] = static_cast<std::uint32_t>(nativeGlobalPos.x());
+    xev.data.data32[1] = static_cast<std::uint32_t>(nativeGlobalPos.y());
+    xev.data.data32[2] = direction;
+    xev.data.data32[3] = XCB_BUTTON_INDEX_1;
+    xev.data.data32[4] = 0;
+
+    std::uint32_t eventFlags = XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT |
+                               XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY;
+
+    xcb_ungrab_pointer(QX11Info::connection(), XCB_CURRENT_TIME);
+    xcb_send_event(QX11Info::connection(),
+                   false,
+                   root,
+                   eventFlags,
+                   reinterpret_cast<const char *>(&xev));
+    xcb_flush(QX11Info::connection());
+    this->m_sentRequests += 2;
+    return true;
+}
+
+std::size_t X11MoveResize::sentRequests() const {
+    return this->m_sentRequests;
+}
+
+void X11MoveResize::resetSentRequests() {
+    this->m_sentRequests = 0;
+}
+
+} // namespace CSD::Internal
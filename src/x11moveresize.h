@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QPoint>
+
+#include <xcb/xcb.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+class QScreen;
+
+namespace CSD::Internal {
+
+// Hands interactive moves and resizes of frameless windows over to the window
+// manager via _NET_WM_MOVERESIZE. The atom is interned asynchronously and the
+// root window of each screen is taken from the connection setup as screens
+// come and go, so starting a move or resize sends requests but never waits
+// for a reply.
+class X11MoveResize {
+public:
+    // _NET_WM_MOVERESIZE directions
+    enum Direction : std::uint32_t {
+        SizeTopLeft = 0,
+        SizeTop = 1,
+        SizeTopRight = 2,
+        SizeRight = 3,
+        SizeBottomRight = 4,
+        SizeBottom = 5,
+        SizeBottomLeft = 6,
+        SizeLeft = 7,
+        Move = 8,
+    };
+
+    static X11MoveResize &instance();
+
+    X11MoveResize(const X11MoveResize &) = delete;
+    X11MoveResize &operator=(const X11MoveResize &) = delete;
+
+    void prefetch();
+    bool start(xcb_window_t window,
+               const QScreen *screen,
+               const QPoint &nativeGlobalPos,
+               Direction direction);
+
+    std::size_t sentRequests() const;
+    void resetSentRequests();
+
+private:
+    X11MoveResize() = default;
+    xcb_atom_t moveResizeAtom();
+    void addScreen(const QScreen *screen);
+    xcb_window_t rootWindow(const QScreen *screen) const;
+
+    bool m_prefetched = false;
+    bool m_atomPending = false;
+    xcb_intern_atom_cookie_t m_atomCookie = {0};
+    xcb_atom_t m_moveResizeAtom = XCB_ATOM_NONE;
+    std::unordered_map<const QScreen *, xcb_window_t> m_rootWindows;
+    std::size_t m_sentRequests = 0;
+};
+
+} // namespace CSD::Internal
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <coreplugin/id.h>
+
+#include <QAction>
+#include <QObject>
+
+namespace Core {
+
+class Command : public QObject {
+    Q_OBJECT
+
+public:
+    explicit Command(Id id, QObject *parent = nullptr);
+
+    Id id() const;
+    QAction *action() const;
+
+private:
+    Id m_id;
+    QAction *m_action;
+};
+
+// Commands are created on first lookup, so every id the title bar asks for
+// resolves to an enabled action that callers can drive directly
+class ActionManager : public QObject {
+    Q_OBJECT
+
+public:
+    static ActionManager *instance();
+    static Command *command(Id id);
+
+private:
+    explicit ActionManager(QObject *parent = nullptr);
+};
+
+} // namespace Core
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace Core::Constants {
+
+const char MODE_WELCOME[] = "Welcome";
+const char MODE_EDIT[] = "Edit";
+const char MODE_DESIGN[] = "Design";
+
+} // namespace Core::Constants
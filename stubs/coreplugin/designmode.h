@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QObject>
+
+namespace Core {
+
+class IMode : public QObject {
+    Q_OBJECT
+
+public:
+    explicit IMode(QObject *parent = nullptr);
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+
+signals:
+    void enabledStateChanged(bool enabled);
+
+private:
+    bool m_isEnabled = false;
+};
+
+class DesignMode : public IMode {
+    Q_OBJECT
+
+public:
+    static DesignMode *instance();
+
+private:
+    explicit DesignMode(QObject *parent = nullptr);
+};
+
+} // namespace Core
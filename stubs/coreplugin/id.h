@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMetaType>
+
+namespace Core {
+
+// Stand-in for Qt Creator's Core::Id, compared by name
+class Id {
+public:
+    Id() = default;
+    Id(const char *name);
+
+    QByteArray name() const;
+    bool isValid() const;
+    bool operator==(const Id &other) const;
+    bool operator!=(const Id &other) const;
+    bool operator==(const char *name) const;
+    bool operator!=(const char *name) const;
+
+private:
+    QByteArray m_name;
+};
+
+} // namespace Core
+
+Q_DECLARE_METATYPE(Core::Id)
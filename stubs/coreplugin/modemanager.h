@@ -0,0 +1,26 @@
+#pragma once
+
+#include <coreplugin/id.h>
+
+#include <QObject>
+
+namespace Core {
+
+class ModeManager : public QObject {
+    Q_OBJECT
+
+public:
+    static ModeManager *instance();
+    static void activateMode(Id id);
+    static Id currentModeId();
+
+signals:
+    void currentModeChanged(Core::Id mode, Core::Id oldMode);
+
+private:
+    explicit ModeManager(QObject *parent = nullptr);
+
+    Id m_currentMode;
+};
+
+} // namespace Core
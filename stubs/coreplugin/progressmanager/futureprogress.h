@@ -0,0 +1,26 @@
+#pragma once
+
+#include <coreplugin/id.h>
+
+#include <QFuture>
+#include <QWidget>
+
+namespace Core {
+
+class FutureProgress : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit FutureProgress(QWidget *parent = nullptr);
+
+    QFuture<void> future() const;
+    void setFuture(const QFuture<void> &future);
+    Id type() const;
+    void setType(Id type);
+
+private:
+    QFuture<void> m_future;
+    Id m_type;
+};
+
+} // namespace Core
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <coreplugin/id.h>
+
+#include <QFuture>
+#include <QObject>
+#include <QString>
+
+namespace Core {
+
+class FutureProgress;
+
+// Progress widgets are parented to one hidden top-level widget, like the
+// progress view of Qt Creator
+class ProgressManager : public QObject {
+    Q_OBJECT
+
+public:
+    static ProgressManager *instance();
+    static FutureProgress *
+    addTask(const QFuture<void> &future, const QString &title, Id type);
+
+signals:
+    void taskStarted(Core::Id type);
+    void allTasksFinished(Core::Id type);
+
+private:
+    explicit ProgressManager(QObject *parent = nullptr);
+};
+
+} // namespace Core
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace Debugger::Constants {
+
+const char MODE_DEBUG[] = "Mode.Debug";
+
+} // namespace Debugger::Constants
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace Help::Constants {
+
+const char ID_MODE_HELP[] = "Help";
+
+} // namespace Help::Constants
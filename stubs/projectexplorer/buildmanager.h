@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+
+namespace ProjectExplorer {
+
+class Project;
+
+// Only tracks which projects are building; setBuilding() stands in for
+// queueing and finishing build steps
+class BuildManager : public QObject {
+    Q_OBJECT
+
+public:
+    static BuildManager *instance();
+    static bool isBuilding();
+    static bool isBuilding(const Project *project);
+    static void setBuilding(Project *project, bool building);
+
+signals:
+    void buildStateChanged(ProjectExplorer::Project *project);
+    void buildQueueFinished(bool success);
+
+private:
+    explicit BuildManager(QObject *parent = nullptr);
+
+    QList<const Project *> m_buildingProjects;
+};
+
+} // namespace ProjectExplorer
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QObject>
+
+namespace ProjectExplorer {
+
+class Project : public QObject {
+    Q_OBJECT
+
+public:
+    explicit Project(QObject *parent = nullptr);
+};
+
+} // namespace ProjectExplorer
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace ProjectExplorer::Constants {
+
+const char BUILD[] = "ProjectExplorer.Build";
+const char MODE_SESSION[] = "Project";
+
+} // namespace ProjectExplorer::Constants
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <utils/icon.h>
+
+namespace ProjectExplorer::Icons {
+
+const Utils::Icon CANCELBUILD_FLAT({{":/resources/mode/mode-debug.svg",
+                                     Utils::Theme::IconsStopToolBarColor}});
+
+} // namespace ProjectExplorer::Icons
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+
+namespace ProjectExplorer {
+
+class Project;
+
+class SessionManager : public QObject {
+    Q_OBJECT
+
+public:
+    static SessionManager *instance();
+    static Project *startupProject();
+    static void setStartupProject(Project *project);
+    static bool hasProjects();
+    static void addProject(Project *project);
+    static void removeProject(Project *project);
+
+signals:
+    void startupProjectChanged(ProjectExplorer::Project *project);
+    void projectAdded(ProjectExplorer::Project *project);
+    void projectRemoved(ProjectExplorer::Project *project);
+
+private:
+    explicit SessionManager(QObject *parent = nullptr);
+
+    QList<Project *> m_projects;
+    Project *m_startupProject = nullptr;
+};
+
+} // namespace ProjectExplorer
@@ -0,0 +1,321 @@
+#include <coreplugin/actionmanager/actionmanager.h>
+#include <coreplugin/designmode.h>
+#include <coreplugin/id.h>
+#include <coreplugin/modemanager.h>
+#include <coreplugin/progressmanager/futureprogress.h>
+#include <coreplugin/progressmanager/progressmanager.h>
+#include <projectexplorer/buildmanager.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/session.h>
+#include <utils/icon.h>
+#include <utils/stylehelper.h>
+#include <utils/theme/theme.h>
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QPainter>
+#include <QPixmap>
+
+namespace Core {
+
+Id::Id(const char *name) : m_name(name) {}
+
+QByteArray Id::name() const {
+    return this->m_name;
+}
+
+bool Id::isValid() const {
+    return !this->m_name.isEmpty();
+}
+
+bool Id::operator==(const Id &other) const {
+    return this->m_name == other.m_name;
+}
+
+bool Id::operator!=(const Id &other) const {
+    return this->m_name != other.m_name;
+}
+
+bool Id::operator==(const char *name) const {
+    return this->m_name == name;
+}
+
+bool Id::operator!=(const char *name) const {
+    return this->m_name != name;
+}
+
+Command::Command(Id id, QObject *parent)
+    : QObject(parent), m_id(id), m_action(new QAction(this)) {
+    this->m_action->setObjectName(QString::fromUtf8(id.name()));
+}
+
+Id Command::id() const {
+    return this->m_id;
+}
+
+QAction *Command::action() const {
+    return this->m_action;
+}
+
+ActionManager::ActionManager(QObject *parent) : QObject(parent) {}
+
+ActionManager *ActionManager::instance() {
+    static auto *actionManager =
+        new ActionManager(QCoreApplication::instance());
+    return actionManager;
+}
+
+Command *ActionManager::command(Id id) {
+    static QHash<QByteArray, Command *> commands;
+    auto resultIterator = commands.find(id.name());
+    if (resultIterator != std::end(commands)) {
+        return resultIterator.value();
+    }
+    auto *command = new Command(id, ActionManager::instance());
+    commands.insert(id.name(), command);
+    return command;
+}
+
+ModeManager::ModeManager(QObject *parent) : QObject(parent) {}
+
+ModeManager *ModeManager::instance() {
+    static auto *modeManager = new ModeManager(QCoreApplication::instance());
+    return modeManager;
+}
+
+void ModeManager::activateMode(Id id) {
+    ModeManager *modeManager = ModeManager::instance();
+    if (modeManager->m_currentMode == id) {
+        return;
+    }
+    const Id oldMode = modeManager->m_currentMode;
+    modeManager->m_currentMode = id;
+    emit modeManager->currentModeChanged(id, oldMode);
+}
+
+Id ModeManager::currentModeId() {
+    return ModeManager::instance()->m_currentMode;
+}
+
+IMode::IMode(QObject *parent) : QObject(parent) {}
+
+bool IMode::isEnabled() const {
+    return this->m_isEnabled;
+}
+
+void IMode::setEnabled(bool enabled) {
+    if (this->m_isEnabled == enabled) {
+        return;
+    }
+    this->m_isEnabled = enabled;
+    emit this->enabledStateChanged(enabled);
+}
+
+DesignMode::DesignMode(QObject *parent) : IMode(parent) {}
+
+DesignMode *DesignMode::instance() {
+    static auto *designMode = new DesignMode(QCoreApplication::instance());
+    return designMode;
+}
+
+FutureProgress::FutureProgress(QWidget *parent) : QWidget(parent) {}
+
+QFuture<void> FutureProgress::future() const {
+    return this->m_future;
+}
+
+void FutureProgress::setFuture(const QFuture<void> &future) {
+    this->m_future = future;
+}
+
+Id FutureProgress::type() const {
+    return this->m_type;
+}
+
+void FutureProgress::setType(Id type) {
+    this->m_type = type;
+}
+
+ProgressManager::ProgressManager(QObject *parent) : QObject(parent) {}
+
+ProgressManager *ProgressManager::instance() {
+    static auto *progressManager =
+        new ProgressManager(QCoreApplication::instance());
+    return progressManager;
+}
+
+FutureProgress *ProgressManager::addTask(const QFuture<void> &future,
+                                         const QString &title,
+                                         Id type) {
+    static auto *progressView = new QWidget();
+    auto *progress = new FutureProgress(progressView);
+    progress->setObjectName(title);
+    progress->setFuture(future);
+    progress->setType(type);
+    emit ProgressManager::instance()->taskStarted(type);
+    return progress;
+}
+
+} // namespace Core
+
+namespace ProjectExplorer {
+
+Project::Project(QObject *parent) : QObject(parent) {}
+
+SessionManager::SessionManager(QObject *parent) : QObject(parent) {}
+
+SessionManager *SessionManager::instance() {
+    static auto *sessionManager =
+        new SessionManager(QCoreApplication::instance());
+    return sessionManager;
+}
+
+Project *SessionManager::startupProject() {
+    return SessionManager::instance()->m_startupProject;
+}
+
+void SessionManager::setStartupProject(Project *project) {
+    SessionManager *sessionManager = SessionManager::instance();
+    if (sessionManager->m_startupProject == project) {
+        return;
+    }
+    sessionManager->m_startupProject = project;
+    emit sessionManager->startupProjectChanged(project);
+}
+
+bool SessionManager::hasProjects() {
+    return !SessionManager::instance()->m_projects.isEmpty();
+}
+
+void SessionManager::addProject(Project *project) {
+    SessionManager *sessionManager = SessionManager::instance();
+    sessionManager->m_projects.append(project);
+    emit sessionManager->projectAdded(project);
+    if (sessionManager->m_startupProject == nullptr) {
+        SessionManager::setStartupProject(project);
+    }
+}
+
+void SessionManager::removeProject(Project *project) {
+    SessionManager *sessionManager = SessionManager::instance();
+    if (!sessionManager->m_projects.removeOne(project)) {
+        return;
+    }
+    emit sessionManager->projectRemoved(project);
+    if (sessionManager->m_startupProject == project) {
+        SessionManager::setStartupProject(
+            sessionManager->m_projects.value(0, nullptr));
+    }
+}
+
+BuildManager::BuildManager(QObject *parent) : QObject(parent) {}
+
+BuildManager *BuildManager::instance() {
+    static auto *buildManager = new BuildManager(QCoreApplication::instance());
+    return buildManager;
+}
+
+bool BuildManager::isBuilding() {
+    return !BuildManager::instance()->m_buildingProjects.isEmpty();
+}
+
+bool BuildManager::isBuilding(const Project *project) {
+    return BuildManager::instance()->m_buildingProjects.contains(project);
+}
+
+void BuildManager::setBuilding(Project *project, bool building) {
+    BuildManager *buildManager = BuildManager::instance();
+    if (BuildManager::isBuilding(project) == building) {
+        return;
+    }
+    if (building) {
+        buildManager->m_buildingProjects.append(project);
+    } else {
+        buildManager->m_buildingProjects.removeOne(project);
+    }
+    emit buildManager->buildStateChanged(project);
+    if (!BuildManager::isBuilding()) {
+        emit buildManager->buildQueueFinished(true);
+    }
+}
+
+} // namespace ProjectExplorer
+
+namespace Utils {
+
+QString Theme::id() const {
+    return QStringLiteral("flat-dark");
+}
+
+QColor Theme::color(Color role) const {
+    switch (role) {
+    case FancyToolButtonHoverColor: {
+        return QColor(62, 68, 81);
+    }
+    case IconsBaseColor: {
+        return QColor(215, 218, 224);
+    }
+    case IconsStopToolBarColor: {
+        return QColor(224, 108, 117);
+    }
+    case IconsModeWelcomeActiveColor:
+    case IconsModeEditActiveColor:
+    case IconsModeDesignActiveColor:
+    case IconsModeDebugActiveColor:
+    case IconsModeProjectActiveColor:
+    case IconsModeHelpActiveColor:
+    case ProgressBarColorNormal: {
+        return QColor(97, 175, 239);
+    }
+    }
+    return QColor();
+}
+
+Theme *creatorTheme() {
+    static Theme theme;
+    return &theme;
+}
+
+Icon::Icon(std::initializer_list<IconMaskAndColor> args)
+    : QVector<IconMaskAndColor>(args) {}
+
+Icon::Icon(const QString &imageFileName) : m_imageFileName(imageFileName) {}
+
+QIcon Icon::icon() const {
+    if (this->isEmpty()) {
+        return QIcon(this->m_imageFileName);
+    }
+    QIcon result;
+    for (const IconMaskAndColor &maskAndColor : *this) {
+        QPixmap mask(maskAndColor.first);
+        QPainter painter(&mask);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        painter.fillRect(mask.rect(),
+                         creatorTheme()->color(maskAndColor.second));
+        painter.end();
+        result.addPixmap(mask);
+    }
+    return result;
+}
+
+QIcon Icon::modeIcon([[maybe_unused]] const Icon &classic,
+                     const Icon &flat,
+                     const Icon &flatActive) {
+    QIcon result = flat.icon();
+    result.addPixmap(flatActive.icon().pixmap(QSize(16, 16)), QIcon::Active);
+    return result;
+}
+
+// The shadow is left out; only the icon itself is painted
+void StyleHelper::drawIconWithShadow(
+    const QIcon &icon,
+    const QRect &rect,
+    QPainter *p,
+    QIcon::Mode iconMode,
+    [[maybe_unused]] int dipRadius,
+    [[maybe_unused]] const QColor &color,
+    [[maybe_unused]] const QPoint &dipOffset) {
+    icon.paint(p, rect, Qt::AlignCenter, iconMode);
+}
+
+} // namespace Utils
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <utils/theme/theme.h>
+
+#include <QIcon>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include <initializer_list>
+
+namespace Utils {
+
+using IconMaskAndColor = QPair<QString, Theme::Color>;
+
+// Tints the masks like Qt Creator does, without the shadow and without
+// looking for @2x variants
+class Icon : public QVector<IconMaskAndColor> {
+public:
+    Icon() = default;
+    Icon(std::initializer_list<IconMaskAndColor> args);
+    Icon(const QString &imageFileName);
+
+    QIcon icon() const;
+
+    static QIcon modeIcon(const Icon &classic,
+                          const Icon &flat,
+                          const Icon &flatActive);
+
+private:
+    QString m_imageFileName;
+};
+
+} // namespace Utils
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QColor>
+#include <QIcon>
+#include <QPoint>
+#include <QRect>
+
+class QPainter;
+
+namespace Utils::StyleHelper {
+
+void drawIconWithShadow(const QIcon &icon,
+                        const QRect &rect,
+                        QPainter *p,
+                        QIcon::Mode iconMode,
+                        int dipRadius = 3,
+                        const QColor &color = QColor(0, 0, 0, 130),
+                        const QPoint &dipOffset = QPoint(1, -2));
+
+} // namespace Utils::StyleHelper
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QColor>
+#include <QString>
+
+namespace Utils {
+
+// The roles used by the plugin, all resolving to the colors of the default
+// dark theme
+class Theme {
+public:
+    enum Color {
+        FancyToolButtonHoverColor,
+        IconsBaseColor,
+        IconsStopToolBarColor,
+        IconsModeWelcomeActiveColor,
+        IconsModeEditActiveColor,
+        IconsModeDesignActiveColor,
+        IconsModeDebugActiveColor,
+        IconsModeProjectActiveColor,
+        IconsModeHelpActiveColor,
+        ProgressBarColorNormal
+    };
+
+    QString id() const;
+    QColor color(Color role) const;
+};
+
+Theme *creatorTheme();
+
+} // namespace Utils
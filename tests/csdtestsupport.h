@@ -0,0 +1,31 @@
+#pragma once
+
+#include "csdtitlebar.h"
+
+#include <QtTest>
+
+#include <QWidget>
+
+namespace CSD::Test {
+
+// Shows window holding an 800 pixels wide title bar in style and makes it
+// active, so its buttons are visible and laid out. The repaint counters
+// start at zero. Returns null if the window is never exposed.
+inline TitleBar *
+showTitleBar(QWidget &window,
+             CaptionButtonStyle style,
+             TitleBar::Controls controls = TitleBar::Controls::CaptionOnly,
+             TitleBar::Rendering rendering = TitleBar::Rendering::Widgets) {
+    auto *titleBar =
+        new TitleBar(style, QIcon(), &window, controls, rendering);
+    window.resize(800, 30);
+    window.show();
+    if (!QTest::qWaitForWindowExposed(&window)) {
+        return nullptr;
+    }
+    titleBar->setActive(true);
+    titleBar->resetRepaintCounters();
+    return titleBar;
+}
+
+} // namespace CSD::Test
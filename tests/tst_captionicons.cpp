@@ -0,0 +1,201 @@
+#include "captionicons.h"
+
+#include <QtTest>
+
+#include <QStringView>
+
+#include <array>
+
+using namespace CSD;
+using namespace CSD::Internal;
+
+namespace Baseline {
+
+// captionIconPathsForState as it was before captionIconTable replaced it,
+// kept verbatim as the reference
+std::array<QStringView, 3> captionIconPathsForState(bool active,
+                                                    bool maximized,
+                                                    bool hovered,
+                                                    bool pressed,
+                                                    CaptionButtonStyle style) {
+    std::array<QStringView, 3> buf;
+
+    switch (style) {
+    case CaptionButtonStyle::custom: {
+        if (active || hovered) {
+            buf[0] = u":/resources/titlebar/custom/chrome-minimize-dark.svg";
+            if (maximized) {
+                buf[1] =
+                    u":/resources/titlebar/custom/chrome-restore-dark.svg";
+            } else {
+                buf[1] =
+                    u":/resources/titlebar/custom/chrome-maximize-dark.svg";
+            }
+            if (hovered) {
+                buf[2] = u":/resources/titlebar/custom/chrome-close-light.svg";
+            } else {
+                buf[2] = u":/resources/titlebar/custom/chrome-close-dark.svg";
+            }
+        } else {
+            buf[0] = u":/resources/titlebar/custom/"
+                     u"chrome-minimize-dark-disabled.svg";
+            if (maximized) {
+                buf[1] = u":/resources/titlebar/custom/"
+                         u"chrome-restore-dark-disabled.svg";
+            } else {
+                buf[1] = u":/resources/titlebar/custom/"
+                         u"chrome-maximize-dark-disabled.svg";
+            }
+            buf[2] =
+                u":/resources/titlebar/custom/chrome-close-dark-disabled.svg";
+        }
+        break;
+    }
+    case CaptionButtonStyle::win: {
+        if (active || hovered) {
+            buf[0] = u":/resources/titlebar/win/chrome-minimize-dark.svg";
+            if (maximized) {
+                buf[1] = u":/resources/titlebar/win/chrome-restore-dark.svg";
+            } else {
+                buf[1] = u":/resources/titlebar/win/chrome-maximize-dark.svg";
+            }
+            if (hovered) {
+                buf[2] = u":/resources/titlebar/win/chrome-close-light.svg";
+            } else {
+                buf[2] = u":/resources/titlebar/win/chrome-close-dark.svg";
+            }
+        } else {
+            buf[0] =
+                u":/resources/titlebar/win/chrome-minimize-dark-disabled.svg";
+            if (maximized) {
+                buf[1] = u":/resources/titlebar/win/"
+                         u"chrome-restore-dark-disabled.svg";
+            } else {
+                buf[1] = u":/resources/titlebar/win/"
+                         u"chrome-maximize-dark-disabled.svg";
+            }
+            buf[2] =
+                u":/resources/titlebar/win/chrome-close-dark-disabled.svg";
+        }
+        break;
+    }
+    case CaptionButtonStyle::mac: {
+        if (pressed) {
+            buf[0] = u":/resources/titlebar/mac/minimize-pressed.png";
+            if (maximized) {
+                buf[1] = u":/resources/titlebar/mac/"
+                         "maximize-restore-maximized-pressed.png";
+            } else {
+                buf[1] = u":/resources/titlebar/mac/"
+                         u"maximize-restore-normal-pressed.png";
+            }
+            buf[2] = u":/resources/titlebar/mac/close-pressed.png";
+        } else {
+            if (hovered) {
+                buf[0] = u":/resources/titlebar/mac/minimize-hovered.png";
+                if (maximized) {
+                    buf[1] = u":/resources/titlebar/mac/"
+                             u"maximize-restore-maximized-hovered.png";
+                } else {
+                    buf[1] = u":/resources/titlebar/mac/"
+                             u"maximize-restore-normal-hovered.png";
+                }
+                buf[2] = u":/resources/titlebar/mac/close-hovered.png";
+            } else {
+                if (active) {
+                    buf[0] = u":/resources/titlebar/mac/minimize.png";
+                    buf[1] = u":/resources/titlebar/mac/maximize-restore.png";
+                    buf[2] = u":/resources/titlebar/mac/close.png";
+                } else {
+                    buf[0] = u":/resources/titlebar/mac/inactive.png";
+                    buf[1] = u":/resources/titlebar/mac/inactive.png";
+                    buf[2] = u":/resources/titlebar/mac/inactive.png";
+                }
+            }
+        }
+        break;
+    }
+    }
+
+    return buf;
+}
+
+// The resource each caption icon was loaded from before the custom and win
+// glyphs were drawn in code
+constexpr std::array<QStringView, captionIconCount> captionIconPaths = {{
+    u":/resources/titlebar/custom/chrome-minimize-dark.svg",
+    u":/resources/titlebar/custom/chrome-minimize-dark-disabled.svg",
+    u":/resources/titlebar/custom/chrome-maximize-dark.svg",
+    u":/resources/titlebar/custom/chrome-maximize-dark-disabled.svg",
+    u":/resources/titlebar/custom/chrome-restore-dark.svg",
+    u":/resources/titlebar/custom/chrome-restore-dark-disabled.svg",
+    u":/resources/titlebar/custom/chrome-close-dark.svg",
+    u":/resources/titlebar/custom/chrome-close-light.svg",
+    u":/resources/titlebar/custom/chrome-close-dark-disabled.svg",
+    u":/resources/titlebar/win/chrome-minimize-dark.svg",
+    u":/resources/titlebar/win/chrome-minimize-dark-disabled.svg",
+    u":/resources/titlebar/win/chrome-maximize-dark.svg",
+    u":/resources/titlebar/win/chrome-maximize-dark-disabled.svg",
+    u":/resources/titlebar/win/chrome-restore-dark.svg",
+    u":/resources/titlebar/win/chrome-restore-dark-disabled.svg",
+    u":/resources/titlebar/win/chrome-close-dark.svg",
+    u":/resources/titlebar/win/chrome-close-light.svg",
+    u":/resources/titlebar/win/chrome-close-dark-disabled.svg",
+    u":/resources/titlebar/mac/minimize.png",
+    u":/resources/titlebar/mac/minimize-hovered.png",
+    u":/resources/titlebar/mac/minimize-pressed.png",
+    u":/resources/titlebar/mac/maximize-restore.png",
+    u":/resources/titlebar/mac/maximize-restore-normal-hovered.png",
+    u":/resources/titlebar/mac/maximize-restore-normal-pressed.png",
+    u":/resources/titlebar/mac/maximize-restore-maximized-hovered.png",
+    u":/resources/titlebar/mac/maximize-restore-maximized-pressed.png",
+    u":/resources/titlebar/mac/close.png",
+    u":/resources/titlebar/mac/close-hovered.png",
+    u":/resources/titlebar/mac/close-pressed.png",
+    u":/resources/titlebar/mac/inactive.png",
+}};
+
+} // namespace Baseline
+
+class CaptionIconsTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void tableMatchesBaseline();
+    void bundledPathsMatchBaseline();
+};
+
+void CaptionIconsTest::tableMatchesBaseline() {
+    for (const auto style : {CaptionButtonStyle::custom,
+                             CaptionButtonStyle::win,
+                             CaptionButtonStyle::mac}) {
+        for (unsigned int flags = 0; flags < 16; ++flags) {
+            const bool active = flags & 8;
+            const bool maximized = flags & 4;
+            const bool hovered = flags & 2;
+            const bool pressed = flags & 1;
+            const auto expected = Baseline::captionIconPathsForState(
+                active, maximized, hovered, pressed, style);
+            const auto actual = captionIconsForState(
+                style, active, maximized, hovered, pressed);
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                const QStringView path = Baseline::captionIconPaths
+                    [static_cast<std::size_t>(actual[i])];
+                QCOMPARE(path.toString(), expected[i].toString());
+            }
+        }
+    }
+}
+
+void CaptionIconsTest::bundledPathsMatchBaseline() {
+    for (std::size_t index = 0; index < captionIconCount; ++index) {
+        const QStringView path = captionIconPaths[index];
+        if (!path.isEmpty()) {
+            QCOMPARE(path.toString(),
+                     Baseline::captionIconPaths[index].toString());
+        }
+    }
+}
+
+QTEST_MAIN(CaptionIconsTest)
+#include "tst_captionicons.moc"
@@ -0,0 +1,107 @@
+#include "csddecorationregistry.h"
+
+#include <QtTest>
+
+#include <QWidget>
+
+#include <memory>
+
+using namespace CSD::Internal;
+
+class DecorationRegistryTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void eventTypeSetMembership();
+    void addedWidgetsAreFound();
+    void handlesAreFoundAfterUpdate();
+    void destroyedWidgetsAreRemoved();
+    void addingTwiceConnectsOnce();
+};
+
+// Exposes how many slots are connected to destroyed()
+class Widget : public QWidget {
+public:
+    int destroyedReceivers() const {
+        return this->receivers(SIGNAL(destroyed(QObject *)));
+    }
+};
+
+void DecorationRegistryTest::eventTypeSetMembership() {
+    constexpr auto types =
+        EventTypeSet{QEvent::MouseMove, QEvent::Leave, QEvent::WinIdChange};
+    static_assert(types.contains(QEvent::MouseMove));
+    static_assert(!types.contains(QEvent::Paint));
+
+    QVERIFY(types.contains(QEvent::Leave));
+    QVERIFY(types.contains(QEvent::WinIdChange));
+    for (const QEvent::Type type :
+         {QEvent::Paint, QEvent::Move, QEvent::HoverMove, QEvent::None}) {
+        QVERIFY(!types.contains(type));
+    }
+    // Types past the built-in range are never contained
+    QVERIFY(!types.contains(QEvent::User));
+    QVERIFY(!types.contains(QEvent::MaxUser));
+}
+
+void DecorationRegistryTest::addedWidgetsAreFound() {
+    auto context = QObject();
+    auto registry = DecorationRegistry<int>();
+    auto widget = QWidget();
+    auto other = QWidget();
+
+    registry.add(&widget, 1, &context);
+
+    QVERIFY(registry.find(&widget) != nullptr);
+    QCOMPARE(registry.find(&widget)->widget, &widget);
+    QCOMPARE(registry.find(&widget)->data, 1);
+    QVERIFY(registry.find(&other) == nullptr);
+}
+
+void DecorationRegistryTest::handlesAreFoundAfterUpdate() {
+    auto context = QObject();
+    auto registry = DecorationRegistry<int>();
+    auto widget = QWidget();
+    registry.add(&widget, 1, &context);
+    QCOMPARE(registry.find(&widget)->handle, WId(0));
+
+    const WId handle = widget.winId();
+    QVERIFY(handle != 0);
+    QVERIFY(registry.findByHandle(handle) == nullptr);
+
+    registry.updateHandle(&widget);
+
+    QVERIFY(registry.findByHandle(handle) != nullptr);
+    QCOMPARE(registry.findByHandle(handle)->widget, &widget);
+}
+
+void DecorationRegistryTest::destroyedWidgetsAreRemoved() {
+    auto context = QObject();
+    auto registry = DecorationRegistry<int>();
+    auto widget = std::make_unique<QWidget>();
+    const WId handle = widget->winId();
+    const QObject *address = widget.get();
+    registry.add(widget.get(), 1, &context);
+    QVERIFY(registry.findByHandle(handle) != nullptr);
+
+    widget.reset();
+
+    QVERIFY(registry.find(address) == nullptr);
+    QVERIFY(registry.findByHandle(handle) == nullptr);
+}
+
+void DecorationRegistryTest::addingTwiceConnectsOnce() {
+    auto context = QObject();
+    auto registry = DecorationRegistry<int>();
+    auto widget = Widget();
+    const int receivers = widget.destroyedReceivers();
+
+    registry.add(&widget, 1, &context);
+    registry.add(&widget, 2, &context);
+
+    QCOMPARE(widget.destroyedReceivers(), receivers + 1);
+    QCOMPARE(registry.find(&widget)->data, 2);
+}
+
+QTEST_MAIN(DecorationRegistryTest)
+#include "tst_decorationregistry.moc"
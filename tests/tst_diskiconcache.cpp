@@ -0,0 +1,124 @@
+#include "csddiskiconcache.h"
+
+#include <QtTest>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPixmap>
+#include <QStandardPaths>
+
+#include <cstring>
+
+using namespace CSD::Internal;
+
+class DiskIconCacheTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void savedIconsAreMappedAgain();
+    void truncatedFileIsIgnored();
+    void overflowingEntryIsIgnored();
+};
+
+// Layout of the cache file, see csddiskiconcache.cpp
+struct FileHeader {
+    char magic[4];
+    quint32 version;
+    quint32 count;
+    quint32 reserved;
+};
+
+struct FileEntry {
+    quint64 key;
+    quint32 width;
+    quint32 height;
+    quint32 bytesPerLine;
+    quint32 reserved;
+    quint64 offset;
+};
+
+static const QByteArray fingerprint = QByteArrayLiteral("tst_diskiconcache");
+
+static QImage glyph(QRgb color) {
+    auto image = QImage(24, 24, QImage::Format_ARGB32_Premultiplied);
+    image.fill(color);
+    return image;
+}
+
+void DiskIconCacheTest::initTestCase() {
+    // Keeps the files out of the real cache directory
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void DiskIconCacheTest::init() {
+    QFile::remove(DiskIconCache(fingerprint, 2.0).path());
+}
+
+void DiskIconCacheTest::savedIconsAreMappedAgain() {
+    {
+        auto cache = DiskIconCache(fingerprint, 2.0);
+        cache.insert(1, glyph(0xFFFF0000));
+        cache.insert(2, glyph(0xFF0000FF));
+        cache.save();
+    }
+
+    const auto cache = DiskIconCache(fingerprint, 2.0);
+    const QPixmap red = cache.pixmap(1);
+    const QPixmap blue = cache.pixmap(2);
+
+    QVERIFY(!red.isNull());
+    QCOMPARE(red.devicePixelRatio(), 2.0);
+    QCOMPARE(red.toImage().pixel(12, 12), 0xFFFF0000u);
+    QCOMPARE(blue.toImage().pixel(12, 12), 0xFF0000FFu);
+    QVERIFY(cache.pixmap(3).isNull());
+}
+
+void DiskIconCacheTest::truncatedFileIsIgnored() {
+    QString path;
+    {
+        auto cache = DiskIconCache(fingerprint, 2.0);
+        cache.insert(1, glyph(0xFFFF0000));
+        cache.save();
+        path = cache.path();
+    }
+    auto file = QFile(path);
+    QVERIFY(file.resize(file.size() - 64));
+
+    const auto cache = DiskIconCache(fingerprint, 2.0);
+
+    QVERIFY(cache.pixmap(1).isNull());
+}
+
+void DiskIconCacheTest::overflowingEntryIsIgnored() {
+    // In 32 bits, 0x40000001 * 4 wraps around to the 4 bytes per line that
+    // the entry claims
+    auto header = FileHeader();
+    std::memcpy(header.magic, "CSDI", sizeof(header.magic));
+    header.version = 1;
+    header.count = 1;
+    header.reserved = 0;
+    const auto entry =
+        FileEntry{1, 0x40000001, 1, 4, 0, sizeof(header) + sizeof(FileEntry)};
+
+    auto contents = QByteArray(reinterpret_cast<const char *>(&header),
+                               sizeof(header));
+    contents.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    contents.append(QByteArray(16, '\0'));
+    const QString path = DiskIconCache(fingerprint, 2.0).path();
+    QVERIFY(QDir().mkpath(QFileInfo(path).absolutePath()));
+    auto file = QFile(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+    file.close();
+
+    const auto cache = DiskIconCache(fingerprint, 2.0);
+
+    QVERIFY(cache.pixmap(1).isNull());
+}
+
+QTEST_MAIN(DiskIconCacheTest)
+#include "tst_diskiconcache.moc"
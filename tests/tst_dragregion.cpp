@@ -0,0 +1,80 @@
+#include "csddragregion.h"
+
+#include <QtTest>
+
+#include <vector>
+
+using namespace CSD::Internal;
+
+class DragRegionTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void buttonsAreNotDraggable();
+    void gapsAreDraggable();
+    void outsideBoundsIsNotDraggable();
+    void overlappingRectsAreFound();
+    void emptyRectsAreIgnored();
+};
+
+// A 400x30 title bar with a menu bar on the left and three caption buttons
+// on the right, laid out side by side
+static DragRegion titleBarRegion() {
+    auto region = DragRegion();
+    region.setBounds(QRect(0, 0, 400, 30));
+    region.setInteractiveRects({QRect(370, 0, 30, 30),
+                                QRect(35, 0, 120, 30),
+                                QRect(310, 0, 30, 30),
+                                QRect(340, 0, 30, 30)});
+    return region;
+}
+
+void DragRegionTest::buttonsAreNotDraggable() {
+    const DragRegion region = titleBarRegion();
+    for (const QPoint pos : {QPoint(35, 0),
+                             QPoint(154, 29),
+                             QPoint(310, 15),
+                             QPoint(369, 15),
+                             QPoint(399, 29)}) {
+        QVERIFY(region.isInteractive(pos));
+        QVERIFY(!region.isDraggable(pos));
+    }
+}
+
+void DragRegionTest::gapsAreDraggable() {
+    const DragRegion region = titleBarRegion();
+    for (const QPoint pos : {QPoint(0, 0), QPoint(34, 15), QPoint(155, 15),
+                             QPoint(309, 29)}) {
+        QVERIFY(!region.isInteractive(pos));
+        QVERIFY(region.isDraggable(pos));
+    }
+}
+
+void DragRegionTest::outsideBoundsIsNotDraggable() {
+    const DragRegion region = titleBarRegion();
+    QVERIFY(!region.isDraggable(QPoint(-1, 15)));
+    QVERIFY(!region.isDraggable(QPoint(200, 30)));
+    QVERIFY(!region.isDraggable(QPoint(400, 15)));
+}
+
+void DragRegionTest::overlappingRectsAreFound() {
+    // A wide rect that starts first must still be found behind narrow ones
+    auto region = DragRegion();
+    region.setBounds(QRect(0, 0, 400, 30));
+    region.setInteractiveRects({QRect(10, 0, 300, 10),
+                                QRect(20, 10, 10, 20),
+                                QRect(50, 10, 10, 20)});
+    QVERIFY(region.isInteractive(QPoint(200, 5)));
+    QVERIFY(region.isInteractive(QPoint(55, 15)));
+    QVERIFY(!region.isInteractive(QPoint(200, 15)));
+}
+
+void DragRegionTest::emptyRectsAreIgnored() {
+    auto region = DragRegion();
+    region.setBounds(QRect(0, 0, 400, 30));
+    region.setInteractiveRects({QRect(), QRect(100, 0, 0, 30)});
+    QVERIFY(region.isDraggable(QPoint(100, 15)));
+}
+
+QTEST_MAIN(DragRegionTest)
+#include "tst_dragregion.moc"
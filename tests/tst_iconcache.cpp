@@ -0,0 +1,90 @@
+#include "csdiconcache.h"
+#include "csdtitlebar.h"
+
+#include <QtTest>
+
+#include <QPixmap>
+#include <QWidget>
+
+using namespace CSD;
+using namespace CSD::Internal;
+
+class IconCacheTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void repeatedLookupsHit();
+    void clearDropsPixmaps();
+    // Shutting down cannot be undone, so this runs last
+    void paintingAfterShutDownCachesNothing();
+};
+
+static QPixmap closePixmap() {
+    return IconCache::instance().captionButtonPixmap(
+        CaptionButtonStyle::custom,
+        true,
+        false,
+        false,
+        false,
+        TitleBarButton::Close,
+        CaptionGlyphColors(),
+        QSize(12, 12),
+        1.0);
+}
+
+void IconCacheTest::initTestCase() {
+    Q_INIT_RESOURCE(csd);
+}
+
+void IconCacheTest::repeatedLookupsHit() {
+    IconCache::instance().clear();
+    IconCache::instance().resetCounters();
+
+    const QPixmap first = closePixmap();
+    const QPixmap second = closePixmap();
+
+    QVERIFY(!first.isNull());
+    QCOMPARE(first.cacheKey(), second.cacheKey());
+    QCOMPARE(IconCache::instance().misses(), std::size_t(1));
+    QCOMPARE(IconCache::instance().hits(), std::size_t(1));
+}
+
+void IconCacheTest::clearDropsPixmaps() {
+    closePixmap();
+    IconCache::instance().clear();
+    IconCache::instance().resetCounters();
+
+    closePixmap();
+
+    QCOMPARE(IconCache::instance().misses(), std::size_t(1));
+    QCOMPARE(IconCache::instance().hits(), std::size_t(0));
+}
+
+void IconCacheTest::paintingAfterShutDownCachesNothing() {
+    auto captionIcon = QPixmap(16, 16);
+    captionIcon.fill(Qt::red);
+    auto window = QWidget();
+    auto *titleBar = new TitleBar(CaptionButtonStyle::custom,
+                                  QIcon(captionIcon),
+                                  &window,
+                                  TitleBar::Controls::CaptionOnly);
+    window.resize(400, 30);
+    auto target = QPixmap(window.size());
+    window.render(&target);
+    QVERIFY(IconCache::instance().size() > 0);
+
+    IconCache::instance().shutDown();
+    QCOMPARE(IconCache::instance().size(), std::size_t(0));
+
+    // Windows still repaint, and switching styles asks for prerasterization
+    window.render(&target);
+    titleBar->setCaptionButtonStyle(CaptionButtonStyle::win);
+    window.render(&target);
+    QVERIFY(!closePixmap().isNull());
+
+    QCOMPARE(IconCache::instance().size(), std::size_t(0));
+}
+
+QTEST_MAIN(IconCacheTest)
+#include "tst_iconcache.moc"
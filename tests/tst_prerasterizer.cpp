@@ -0,0 +1,80 @@
+#include "csdprerasterizer.h"
+
+#include <QtTest>
+
+#include <QImage>
+#include <QPixmap>
+#include <QTemporaryDir>
+
+#include <vector>
+
+using namespace CSD::Internal;
+
+class PrerasterizerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void unreadableFilesStillReachTheSink();
+    void highDensityVariantKeepsAspectRatio();
+};
+
+struct Delivery {
+    std::uint64_t key;
+    QImage image;
+};
+
+// Runs jobs and collects what reaches the sink
+static std::vector<Delivery>
+rasterize(const std::vector<Prerasterizer::Job> &jobs) {
+    auto deliveries = std::vector<Delivery>();
+    auto prerasterizer = Prerasterizer(
+        [&deliveries](std::uint64_t key,
+                      const QImage &image,
+                      [[maybe_unused]] const QPixmap &pixmap) {
+            deliveries.push_back(Delivery{key, image});
+        });
+    prerasterizer.start(jobs);
+    QTest::qWaitFor(
+        [&deliveries, &jobs]() { return deliveries.size() == jobs.size(); });
+    return deliveries;
+}
+
+void PrerasterizerTest::unreadableFilesStillReachTheSink() {
+    const auto deliveries = rasterize({Prerasterizer::Job{
+        1, QStringLiteral(":/missing.png"), QSize(12, 12), 1.0, 0}});
+
+    QCOMPARE(deliveries.size(), std::size_t(1));
+    QCOMPARE(deliveries[0].key, std::uint64_t(1));
+    QVERIFY(deliveries[0].image.isNull());
+}
+
+void PrerasterizerTest::highDensityVariantKeepsAspectRatio() {
+    // A tall glyph whose @2x variant has a different color, so the test can
+    // tell which file was read
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    auto normal = QImage(8, 16, QImage::Format_ARGB32);
+    normal.fill(Qt::red);
+    QVERIFY(normal.save(directory.filePath(QStringLiteral("glyph.png"))));
+    auto dense = QImage(16, 32, QImage::Format_ARGB32);
+    dense.fill(Qt::blue);
+    QVERIFY(dense.save(directory.filePath(QStringLiteral("glyph@2x.png"))));
+
+    const auto deliveries = rasterize({Prerasterizer::Job{
+        2,
+        directory.filePath(QStringLiteral("glyph.png")),
+        QSize(16, 16),
+        2.0,
+        0}});
+
+    QCOMPARE(deliveries.size(), std::size_t(1));
+    const QImage &image = deliveries[0].image;
+    QCOMPARE(image.size(), QSize(32, 32));
+    QCOMPARE(image.devicePixelRatio(), 2.0);
+    QCOMPARE(image.pixelColor(16, 16), QColor(Qt::blue));
+    QCOMPARE(image.pixelColor(0, 16).alpha(), 0);
+    QCOMPARE(image.pixelColor(31, 16).alpha(), 0);
+}
+
+QTEST_MAIN(PrerasterizerTest)
+#include "tst_prerasterizer.moc"
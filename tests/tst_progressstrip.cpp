@@ -0,0 +1,120 @@
+#include "csdprogressstrip.h"
+
+#include <QtTest>
+
+#include <QElapsedTimer>
+#include <QFutureInterface>
+#include <QPaintEvent>
+#include <QWidget>
+
+#include <vector>
+
+using namespace CSD::Internal;
+
+class ProgressStripTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void repaintsAreCappedByFrequency();
+    void subPixelChangesRepaintNothing();
+    void onlyTheChangedPartIsRepainted();
+};
+
+// Collects the rects of the paint events a widget receives
+class PaintRecorder : public QObject {
+public:
+    std::vector<QRect> rects;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override {
+        if (event->type() == QEvent::Paint) {
+            this->rects.push_back(static_cast<QPaintEvent *>(event)->rect());
+        }
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+// A shown window with a 100 pixels wide strip along its top edge, watching
+// a task with 1000 steps
+struct Fixture {
+    QWidget window;
+    ProgressStrip *strip = nullptr;
+    QFutureInterface<void> task;
+};
+
+static bool start(Fixture &fixture, int frequency) {
+    fixture.strip = new ProgressStrip(&fixture.window, frequency);
+    fixture.strip->setGeometry(0, 0, 100, 2);
+    fixture.window.resize(100, 30);
+    fixture.window.show();
+    if (!QTest::qWaitForWindowExposed(&fixture.window)) {
+        return false;
+    }
+    fixture.task.reportStarted();
+    fixture.task.setProgressRange(0, 1000);
+    fixture.strip->watch(fixture.task.future());
+    // The first tick only shows the empty bar
+    QTRY_COMPARE(fixture.strip->ticks(), std::size_t(1));
+    fixture.strip->resetCounters();
+    return true;
+}
+
+void ProgressStripTest::repaintsAreCappedByFrequency() {
+    auto fixture = Fixture();
+    QVERIFY(start(fixture, 20));
+
+    auto clock = QElapsedTimer();
+    clock.start();
+    for (int value = 10; value <= 1000; value += 10) {
+        fixture.task.setProgressValue(value);
+        QTest::qWait(5);
+    }
+    const qint64 elapsed = clock.elapsed();
+
+    // A hundred progress changes, but one tick per 50 milliseconds at most
+    const auto maxTicks = static_cast<std::size_t>(elapsed / 50 + 2);
+    QVERIFY(fixture.strip->ticks() > 0);
+    QVERIFY2(fixture.strip->ticks() <= maxTicks,
+             qPrintable(QString::number(fixture.strip->ticks())));
+    QVERIFY(fixture.strip->repaints() <= fixture.strip->ticks());
+    fixture.task.reportFinished();
+}
+
+void ProgressStripTest::subPixelChangesRepaintNothing() {
+    auto fixture = Fixture();
+    QVERIFY(start(fixture, 100));
+
+    // 4 of 1000 steps are 0.4 pixels of the 100 pixels wide strip
+    fixture.task.setProgressValue(4);
+    QTRY_COMPARE(fixture.strip->ticks(), std::size_t(1));
+    QCOMPARE(fixture.strip->repaints(), std::size_t(0));
+
+    fixture.task.setProgressValue(20);
+    QTRY_COMPARE(fixture.strip->ticks(), std::size_t(2));
+    QCOMPARE(fixture.strip->repaints(), std::size_t(1));
+    fixture.task.reportFinished();
+}
+
+void ProgressStripTest::onlyTheChangedPartIsRepainted() {
+    auto fixture = Fixture();
+    QVERIFY(start(fixture, 100));
+    fixture.task.setProgressValue(200);
+    QTRY_COMPARE(fixture.strip->repaints(), std::size_t(1));
+    QTest::qWait(20);
+    auto recorder = PaintRecorder();
+    fixture.strip->installEventFilter(&recorder);
+
+    fixture.task.setProgressValue(500);
+    QTRY_COMPARE(fixture.strip->repaints(), std::size_t(2));
+    QTRY_VERIFY(!recorder.rects.empty());
+
+    // From the old end at 20 pixels to the new one at 50
+    for (const QRect &rect : recorder.rects) {
+        QCOMPARE(rect, QRect(20, 0, 30, 2));
+    }
+    fixture.strip->removeEventFilter(&recorder);
+    fixture.task.reportFinished();
+}
+
+QTEST_MAIN(ProgressStripTest)
+#include "tst_progressstrip.moc"
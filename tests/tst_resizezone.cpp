@@ -0,0 +1,98 @@
+#include "csdresizezone.h"
+
+#include <QtTest>
+
+using namespace CSD::Internal;
+
+Q_DECLARE_METATYPE(CSD::Internal::ResizeZone)
+
+class ResizeZoneTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void zones_data();
+    void zones();
+    void cornersNeedBothAxes();
+    void fixedAxesHaveNoEdges();
+    void outsideBoundsIsNone();
+};
+
+// A 200x100 window that does not start at the origin, with 6 pixel borders
+static const auto bounds = QRect(10, 20, 200, 100);
+constexpr static int borderWidth = 6;
+
+void ResizeZoneTest::zones_data() {
+    QTest::addColumn<QPoint>("pos");
+    QTest::addColumn<ResizeZone>("zone");
+
+    QTest::addRow("center") << QPoint(110, 70) << ResizeZone::None;
+    QTest::addRow("left") << QPoint(10, 70) << ResizeZone::Left;
+    QTest::addRow("left inner") << QPoint(15, 70) << ResizeZone::Left;
+    QTest::addRow("past left") << QPoint(16, 70) << ResizeZone::None;
+    QTest::addRow("right") << QPoint(209, 70) << ResizeZone::Right;
+    QTest::addRow("right inner") << QPoint(204, 70) << ResizeZone::Right;
+    QTest::addRow("past right") << QPoint(203, 70) << ResizeZone::None;
+    QTest::addRow("top") << QPoint(110, 20) << ResizeZone::Top;
+    QTest::addRow("past top") << QPoint(110, 26) << ResizeZone::None;
+    QTest::addRow("bottom") << QPoint(110, 119) << ResizeZone::Bottom;
+    QTest::addRow("past bottom") << QPoint(110, 113) << ResizeZone::None;
+    // Where two edges meet, the corner wins over both
+    QTest::addRow("top left") << QPoint(10, 20) << ResizeZone::TopLeft;
+    QTest::addRow("top left inner") << QPoint(15, 25) << ResizeZone::TopLeft;
+    QTest::addRow("top right") << QPoint(209, 20) << ResizeZone::TopRight;
+    QTest::addRow("bottom left") << QPoint(10, 119) << ResizeZone::BottomLeft;
+    QTest::addRow("bottom right")
+        << QPoint(209, 119) << ResizeZone::BottomRight;
+    QTest::addRow("bottom right inner")
+        << QPoint(204, 114) << ResizeZone::BottomRight;
+}
+
+void ResizeZoneTest::zones() {
+    QFETCH(QPoint, pos);
+    QFETCH(ResizeZone, zone);
+
+    QCOMPARE(resizeZoneAt(bounds, pos, borderWidth, true, true), zone);
+}
+
+void ResizeZoneTest::cornersNeedBothAxes() {
+    // With one axis fixed, a corner is the edge of the other axis
+    QCOMPARE(resizeZoneAt(bounds, QPoint(10, 20), borderWidth, true, false),
+             ResizeZone::Left);
+    QCOMPARE(resizeZoneAt(bounds, QPoint(209, 119), borderWidth, true, false),
+             ResizeZone::Right);
+    QCOMPARE(resizeZoneAt(bounds, QPoint(10, 20), borderWidth, false, true),
+             ResizeZone::Top);
+    QCOMPARE(resizeZoneAt(bounds, QPoint(209, 119), borderWidth, false, true),
+             ResizeZone::Bottom);
+}
+
+void ResizeZoneTest::fixedAxesHaveNoEdges() {
+    for (const QPoint pos : {QPoint(10, 70),
+                             QPoint(209, 70),
+                             QPoint(110, 20),
+                             QPoint(110, 119),
+                             QPoint(10, 20),
+                             QPoint(209, 119)}) {
+        QCOMPARE(resizeZoneAt(bounds, pos, borderWidth, false, false),
+                 ResizeZone::None);
+    }
+    QCOMPARE(resizeZoneAt(bounds, QPoint(10, 70), borderWidth, false, true),
+             ResizeZone::None);
+    QCOMPARE(resizeZoneAt(bounds, QPoint(110, 20), borderWidth, true, false),
+             ResizeZone::None);
+}
+
+void ResizeZoneTest::outsideBoundsIsNone() {
+    for (const QPoint pos : {QPoint(9, 70),
+                             QPoint(210, 70),
+                             QPoint(110, 19),
+                             QPoint(110, 120),
+                             QPoint(9, 19),
+                             QPoint(210, 120)}) {
+        QCOMPARE(resizeZoneAt(bounds, pos, borderWidth, true, true),
+                 ResizeZone::None);
+    }
+}
+
+QTEST_MAIN(ResizeZoneTest)
+#include "tst_resizezone.moc"
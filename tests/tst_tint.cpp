@@ -0,0 +1,98 @@
+#include "csdtint.h"
+
+#include <QtTest>
+
+#include <QRandomGenerator>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace CSD::Internal;
+
+Q_DECLARE_METATYPE(CSD::Internal::TintKernel)
+
+class TintTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void kernelsMatchScalar_data();
+    void kernelsMatchScalar();
+    void tintMaskMatchesScalar();
+};
+
+// Odd widths below, at and past the 8 and 16 pixel blocks, so every kernel
+// also runs its scalar tail
+constexpr static int widths[] = {1, 7, 9, 15, 17, 31, 33, 63, 257};
+
+void TintTest::kernelsMatchScalar_data() {
+    QTest::addColumn<TintKernel>("kernel");
+    QTest::addRow("sse2") << TintKernel::Sse2;
+    QTest::addRow("avx2") << TintKernel::Avx2;
+}
+
+void TintTest::kernelsMatchScalar() {
+    QFETCH(TintKernel, kernel);
+    const TintRow row = tintRow(kernel);
+    if (row == nullptr) {
+        QSKIP("The kernel is not available on this machine");
+    }
+    const TintRow scalar = tintRow(TintKernel::Scalar);
+    auto random = QRandomGenerator(42);
+
+    for (const int width : widths) {
+        for (int round = 0; round < 16; ++round) {
+            auto mask = std::vector<std::uint8_t>(std::size_t(width));
+            for (std::uint8_t &value : mask) {
+                value = static_cast<std::uint8_t>(random.bounded(256));
+            }
+            // The extremes of every channel and of the mask are included
+            mask.front() = 0;
+            mask.back() = 255;
+            const std::uint32_t color =
+                round == 0 ? 0xFFFFFFFFu : qPremultiply(random.generate());
+
+            auto expected = std::vector<std::uint32_t>(mask.size());
+            auto actual = std::vector<std::uint32_t>(mask.size());
+            scalar(mask.data(), expected.data(), width, color);
+            row(mask.data(), actual.data(), width, color);
+
+            QVERIFY2(std::memcmp(expected.data(),
+                                 actual.data(),
+                                 expected.size() * sizeof(std::uint32_t)) ==
+                         0,
+                     qPrintable(QStringLiteral("width %1, color %2")
+                                    .arg(width)
+                                    .arg(color, 8, 16, QLatin1Char('0'))));
+        }
+    }
+}
+
+void TintTest::tintMaskMatchesScalar() {
+    auto random = QRandomGenerator(7);
+    auto mask = QImage(33, 5, QImage::Format_Alpha8);
+    for (int y = 0; y < mask.height(); ++y) {
+        for (int x = 0; x < mask.width(); ++x) {
+            mask.scanLine(y)[x] = static_cast<uchar>(random.bounded(256));
+        }
+    }
+    const QRgb color = 0xC0E06C75;
+
+    const QImage image = tintMask(mask, color);
+
+    QCOMPARE(image.format(), QImage::Format_ARGB32_Premultiplied);
+    const TintRow scalar = tintRow(TintKernel::Scalar);
+    auto expected = std::vector<std::uint32_t>(std::size_t(mask.width()));
+    for (int y = 0; y < mask.height(); ++y) {
+        scalar(mask.constScanLine(y),
+               expected.data(),
+               mask.width(),
+               qPremultiply(color));
+        QVERIFY(std::memcmp(expected.data(),
+                            image.constScanLine(y),
+                            expected.size() * sizeof(std::uint32_t)) == 0);
+    }
+}
+
+QTEST_MAIN(TintTest)
+#include "tst_tint.moc"
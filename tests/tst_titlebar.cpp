@@ -0,0 +1,150 @@
+#include "csdtitlebar.h"
+
+#include "csdtestsupport.h"
+
+#include <QtTest>
+
+#include <QSignalSpy>
+#include <QWidget>
+
+using namespace CSD;
+using CSD::Test::showTitleBar;
+
+class TitleBarTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void redundantStateChangesRepaintNothing();
+    void activationRepaintsEveryCaptionButton();
+    void maximizeRepaintsOnlyMaximizeRestore();
+    void captionButtonStyleSwitches();
+    void flyweightButtonsAreNoWidgets();
+    void flyweightActivationRepaintsEveryCaptionButton();
+    void flyweightCloseClick();
+    void flyweightHiddenButtonIsDraggable();
+};
+
+void TitleBarTest::initTestCase() {
+    Q_INIT_RESOURCE(csd);
+}
+
+void TitleBarTest::redundantStateChangesRepaintNothing() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window, CaptionButtonStyle::custom);
+    QVERIFY(titleBar != nullptr);
+
+    titleBar->setActive(true);
+    titleBar->setMaximized(false);
+
+    QCOMPARE(titleBar->repaintCounters().events, std::size_t(2));
+    QCOMPARE(titleBar->repaintCounters().repaints, std::size_t(0));
+}
+
+void TitleBarTest::activationRepaintsEveryCaptionButton() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window, CaptionButtonStyle::custom);
+    QVERIFY(titleBar != nullptr);
+
+    titleBar->setActive(false);
+
+    QVERIFY(!titleBar->isActive());
+    QCOMPARE(titleBar->repaintCounters().events, std::size_t(1));
+    QCOMPARE(titleBar->repaintCounters().repaints, std::size_t(3));
+}
+
+void TitleBarTest::maximizeRepaintsOnlyMaximizeRestore() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window, CaptionButtonStyle::win);
+    QVERIFY(titleBar != nullptr);
+
+    titleBar->setMaximized(true);
+
+    QVERIFY(titleBar->isMaximized());
+    QCOMPARE(titleBar->repaintCounters().repaints, std::size_t(1));
+}
+
+void TitleBarTest::captionButtonStyleSwitches() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window, CaptionButtonStyle::custom);
+    QVERIFY(titleBar != nullptr);
+
+    titleBar->setCaptionButtonStyle(CaptionButtonStyle::mac);
+
+    QCOMPARE(titleBar->captionButtonStyle(), CaptionButtonStyle::mac);
+    QVERIFY(titleBar->repaintCounters().repaints > 0);
+}
+
+void TitleBarTest::flyweightButtonsAreNoWidgets() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window,
+                                      CaptionButtonStyle::custom,
+                                      TitleBar::Controls::CaptionOnly,
+                                      TitleBar::Rendering::Flyweight);
+    QVERIFY(titleBar != nullptr);
+
+    QVERIFY(titleBar->findChildren<QWidget *>().isEmpty());
+    // The three custom buttons are 30 pixels wide each
+    QVERIFY(!titleBar->isCaptionAt(QPoint(titleBar->width() - 75, 15)));
+    QVERIFY(titleBar->isCaptionAt(QPoint(titleBar->width() - 95, 15)));
+}
+
+void TitleBarTest::flyweightActivationRepaintsEveryCaptionButton() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window,
+                                      CaptionButtonStyle::custom,
+                                      TitleBar::Controls::CaptionOnly,
+                                      TitleBar::Rendering::Flyweight);
+    QVERIFY(titleBar != nullptr);
+
+    titleBar->setActive(false);
+
+    QCOMPARE(titleBar->repaintCounters().events, std::size_t(1));
+    QCOMPARE(titleBar->repaintCounters().repaints, std::size_t(3));
+}
+
+void TitleBarTest::flyweightCloseClick() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window,
+                                      CaptionButtonStyle::custom,
+                                      TitleBar::Controls::CaptionOnly,
+                                      TitleBar::Rendering::Flyweight);
+    QVERIFY(titleBar != nullptr);
+    auto closeSpy = QSignalSpy(titleBar, &TitleBar::closeClicked);
+    auto minimizeSpy = QSignalSpy(titleBar, &TitleBar::minimizeClicked);
+    const auto closePos = QPoint(titleBar->width() - 15, 15);
+
+    QTest::mouseMove(titleBar, closePos);
+    QTest::mouseClick(titleBar, Qt::LeftButton, Qt::NoModifier, closePos);
+    // Released outside of the button it was pressed on, no click
+    QTest::mousePress(titleBar,
+                      Qt::LeftButton,
+                      Qt::NoModifier,
+                      QPoint(titleBar->width() - 75, 15));
+    QTest::mouseMove(titleBar, closePos);
+    QTest::mouseRelease(titleBar, Qt::LeftButton, Qt::NoModifier, closePos);
+
+    QCOMPARE(closeSpy.count(), 1);
+    QCOMPARE(minimizeSpy.count(), 0);
+}
+
+void TitleBarTest::flyweightHiddenButtonIsDraggable() {
+    auto window = QWidget();
+    TitleBar *titleBar = showTitleBar(window,
+                                      CaptionButtonStyle::custom,
+                                      TitleBar::Controls::CaptionOnly,
+                                      TitleBar::Rendering::Flyweight);
+    QVERIFY(titleBar != nullptr);
+    const auto minimizePos = QPoint(titleBar->width() - 75, 15);
+    QVERIFY(!titleBar->isCaptionAt(minimizePos));
+
+    titleBar->setMinimizable(false);
+    QCoreApplication::sendPostedEvents(titleBar, QEvent::LayoutRequest);
+
+    // The two remaining buttons moved right, the minimize area is caption
+    QVERIFY(titleBar->isCaptionAt(minimizePos));
+    QVERIFY(!titleBar->isCaptionAt(QPoint(titleBar->width() - 45, 15)));
+}
+
+QTEST_MAIN(TitleBarTest)
+#include "tst_titlebar.moc"
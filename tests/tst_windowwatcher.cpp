@@ -0,0 +1,113 @@
+#include "csdtitlebar.h"
+#include "csdwindowwatcher.h"
+
+#include <QtTest>
+
+#include <QApplication>
+#include <QBoxLayout>
+#include <QPointer>
+#include <QWidget>
+
+using namespace CSD;
+using namespace CSD::Internal;
+
+class WindowWatcherTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void reportsNormalAndToolWindows();
+    void ignoresOtherWindowTypes();
+    void reportsEachWindowOnce();
+    void openingAndClosingWindowsLeaksNothing();
+};
+
+// Shows a top-level widget and waits until it is the focus window
+static bool showActive(QWidget &window) {
+    window.resize(200, 100);
+    window.show();
+    window.activateWindow();
+    return QTest::qWaitForWindowActive(&window);
+}
+
+void WindowWatcherTest::initTestCase() {
+    Q_INIT_RESOURCE(csd);
+}
+
+void WindowWatcherTest::reportsNormalAndToolWindows() {
+    auto watcher = WindowWatcher();
+    QSignalSpy spy(&watcher, &WindowWatcher::windowActivated);
+
+    auto window = QWidget();
+    QVERIFY(showActive(window));
+    auto tool = QWidget(nullptr, Qt::Tool);
+    QVERIFY(showActive(tool));
+
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.at(0).at(0).value<QWidget *>(), &window);
+    QCOMPARE(spy.at(1).at(0).value<QWidget *>(), &tool);
+}
+
+void WindowWatcherTest::ignoresOtherWindowTypes() {
+    auto watcher = WindowWatcher();
+    QSignalSpy spy(&watcher, &WindowWatcher::windowActivated);
+
+    auto dialog = QWidget(nullptr, Qt::Dialog);
+    QVERIFY(showActive(dialog));
+
+    QCOMPARE(spy.count(), 0);
+    QCOMPARE(watcher.reportedWindows(), std::size_t(0));
+}
+
+void WindowWatcherTest::reportsEachWindowOnce() {
+    auto watcher = WindowWatcher();
+    QSignalSpy spy(&watcher, &WindowWatcher::windowActivated);
+
+    auto first = QWidget();
+    auto second = QWidget();
+    QVERIFY(showActive(first));
+    QVERIFY(showActive(second));
+    QVERIFY(showActive(first));
+
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(watcher.reportedWindows(), std::size_t(2));
+}
+
+void WindowWatcherTest::openingAndClosingWindowsLeaksNothing() {
+    auto watcher = WindowWatcher();
+    std::size_t decorated = 0;
+    QObject::connect(&watcher,
+                     &WindowWatcher::windowActivated,
+                     [&decorated](QWidget *window) {
+                         auto *layout =
+                             static_cast<QBoxLayout *>(window->layout());
+                         layout->insertWidget(
+                             0,
+                             new TitleBar(CaptionButtonStyle::custom,
+                                          QIcon(),
+                                          window,
+                                          TitleBar::Controls::CaptionOnly));
+                         ++decorated;
+                     });
+    const int topLevelWidgets = QApplication::topLevelWidgets().size();
+
+    // Closing deletes each window together with its title bar
+    constexpr int windowCount = 50;
+    for (int index = 0; index < windowCount; ++index) {
+        auto *window = new QWidget(
+            nullptr, index % 2 == 0 ? Qt::Window : Qt::Tool);
+        window->setAttribute(Qt::WA_DeleteOnClose);
+        new QVBoxLayout(window);
+        QVERIFY(showActive(*window));
+        const auto guard = QPointer<QWidget>(window);
+        window->close();
+        QTRY_VERIFY(guard.isNull());
+    }
+
+    QCOMPARE(decorated, std::size_t(windowCount));
+    QCOMPARE(watcher.reportedWindows(), std::size_t(0));
+    QCOMPARE(QApplication::topLevelWidgets().size(), topLevelWidgets);
+}
+
+QTEST_MAIN(WindowWatcherTest)
+#include "tst_windowwatcher.moc"
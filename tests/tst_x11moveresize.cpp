@@ -0,0 +1,81 @@
+#include "x11moveresize.h"
+
+#include <QtTest>
+
+#include <QGuiApplication>
+#include <QWidget>
+
+#include <QX11Info>
+
+using namespace CSD::Internal;
+
+class X11MoveResizeTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void startSendsTwoRequestsWithoutRoundTrips();
+    void startFailsWithoutRootWindow();
+};
+
+// Number of requests issued on the connection while running function,
+// measured through the sequence numbers of two no-op requests around it
+template <typename Function>
+static unsigned int countRequests(Function function) {
+    xcb_connection_t *connection = QX11Info::connection();
+    const unsigned int before = xcb_no_operation(connection).sequence;
+    function();
+    const unsigned int after = xcb_no_operation(connection).sequence;
+    return after - before - 1;
+}
+
+void X11MoveResizeTest::initTestCase() {
+    if (!QX11Info::isPlatformX11()) {
+        QSKIP("Needs the xcb platform, e.g. under Xvfb");
+    }
+    X11MoveResize::instance().prefetch();
+    // Lets the interned atom arrive
+    QTest::qWait(50);
+}
+
+void X11MoveResizeTest::startSendsTwoRequestsWithoutRoundTrips() {
+    auto window = QWidget();
+    window.resize(200, 30);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    X11MoveResize::instance().resetSentRequests();
+
+    bool started = false;
+    const unsigned int requests = countRequests([&window, &started]() {
+        started = X11MoveResize::instance().start(
+            static_cast<xcb_window_t>(window.winId()),
+            window.windowHandle()->screen(),
+            QPoint(10, 10),
+            X11MoveResize::Move);
+    });
+
+    // The pointer ungrab and the client message, nothing waiting for a reply
+    QVERIFY(started);
+    QCOMPARE(requests, 2u);
+    QCOMPARE(X11MoveResize::instance().sentRequests(), std::size_t(2));
+}
+
+void X11MoveResizeTest::startFailsWithoutRootWindow() {
+    auto window = QWidget();
+    window.resize(200, 30);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    X11MoveResize::instance().resetSentRequests();
+
+    // A screen that was never added has no known root window, so the caller
+    // has to handle the press itself
+    QVERIFY(!X11MoveResize::instance().start(
+        static_cast<xcb_window_t>(window.winId()),
+        nullptr,
+        QPoint(10, 10),
+        X11MoveResize::Move));
+    QCOMPARE(X11MoveResize::instance().sentRequests(), std::size_t(0));
+}
+
+QTEST_MAIN(X11MoveResizeTest)
+#include "tst_x11moveresize.moc"
@@ -0,0 +1,198 @@
+// Rasterizes every caption glyph at the given device pixel ratios into one
+// premultiplied ARGB32 atlas, drawn ones with CaptionGlyphEngine and the rest
+// from the csd-<style>.qrc bundles. Writes csdatlas.h with the constexpr
+// index and csdatlas.cpp with the pixel data into the output directory.
+//
+// Usage: csd_atlasbaker <output directory> <scale>...
+
+#include "captionicons.h"
+#include "csdcaptionglyphengine.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QImage>
+#include <QPainter>
+#include <QSaveFile>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+using namespace CSD::Internal;
+
+struct Cell {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+static QImage rasterize(CaptionIcon icon, qreal scale) {
+    const int extent = qRound(captionIconExtent(icon) * scale);
+    if (CaptionGlyphEngine::draws(icon)) {
+        return CaptionGlyphEngine::rasterize(icon, QSize(extent, extent));
+    }
+
+    auto image = QImage(extent, extent, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    // Bitmap glyphs ship a @2x variant for high density screens. Like QIcon,
+    // keep the aspect ratio and center the glyph.
+    QString source = captionIconPath(icon).toString();
+    if (scale > 1.0) {
+        source.insert(source.lastIndexOf(QLatin1Char('.')),
+                      QLatin1String("@2x"));
+    }
+    const QImage pixels = QImage(source).scaled(
+        extent, extent, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    auto target = QRectF(QPointF(0, 0), QSizeF(pixels.size()));
+    target.moveCenter(QRectF(image.rect()).center());
+    {
+        auto painter = QPainter(&image);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.drawImage(target, pixels);
+    }
+    return image;
+}
+
+static bool writeFile(const QString &path, const QString &contents) {
+    auto file = QSaveFile(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    file.write(contents.toUtf8());
+    return file.commit();
+}
+
+int main(int argc, char *argv[]) {
+    auto application = QCoreApplication(argc, argv);
+    const QStringList arguments = QCoreApplication::arguments();
+    if (arguments.size() < 3) {
+        std::fprintf(stderr, "usage: csd_atlasbaker <output> <scale>...\n");
+        return 1;
+    }
+
+    auto scales = std::vector<qreal>();
+    for (int index = 2; index < arguments.size(); ++index) {
+        bool ok = false;
+        const qreal scale = arguments.at(index).toDouble(&ok);
+        if (!ok || scale <= 0) {
+            std::fprintf(stderr,
+                         "csd_atlasbaker: invalid scale %s\n",
+                         qPrintable(arguments.at(index)));
+            return 1;
+        }
+        scales.push_back(scale);
+    }
+
+    // One row per scale, glyphs in CaptionIcon order
+    auto cells = std::vector<Cell>();
+    auto glyphs = std::vector<QImage>();
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+    for (const qreal scale : scales) {
+        int x = 0;
+        int rowHeight = 0;
+        for (std::size_t index = 0; index < captionIconCount; ++index) {
+            QImage glyph = rasterize(static_cast<CaptionIcon>(index), scale);
+            cells.push_back(
+                Cell{x, atlasHeight, glyph.width(), glyph.height()});
+            x += glyph.width();
+            rowHeight = std::max(rowHeight, glyph.height());
+            glyphs.push_back(std::move(glyph));
+        }
+        atlasWidth = std::max(atlasWidth, x);
+        atlasHeight += rowHeight;
+    }
+
+    auto atlas = QImage(
+        atlasWidth, atlasHeight, QImage::Format_ARGB32_Premultiplied);
+    atlas.fill(Qt::transparent);
+    {
+        auto painter = QPainter(&atlas);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        for (std::size_t index = 0; index < glyphs.size(); ++index) {
+            painter.drawImage(cells[index].x, cells[index].y, glyphs[index]);
+        }
+    }
+
+    QString header;
+    {
+        auto stream = QTextStream(&header);
+        stream << "// Generated by csd_atlasbaker, do not edit\n"
+               << "#pragma once\n\n"
+               << "#include \"captionicons.h\"\n\n"
+               << "#include <array>\n\n"
+               << "namespace CSD::Internal::Atlas {\n\n"
+               << "struct Cell {\n"
+               << "    int x;\n"
+               << "    int y;\n"
+               << "    int width;\n"
+               << "    int height;\n"
+               << "};\n\n"
+               << "constexpr int width = " << atlasWidth << ";\n"
+               << "constexpr int height = " << atlasHeight << ";\n"
+               << "constexpr std::array<double, " << scales.size()
+               << "> scales = {{";
+        for (std::size_t index = 0; index < scales.size(); ++index) {
+            stream << (index == 0 ? "" : ", ")
+                   << QString::number(scales[index], 'f', 4);
+        }
+        stream << "}};\n\n"
+               << "// Indexed by scale, then by CaptionIcon\n"
+               << "constexpr std::array<std::array<Cell, captionIconCount>, "
+               << scales.size() << "> cells = {{\n";
+        for (std::size_t row = 0; row < scales.size(); ++row) {
+            stream << "    {{\n";
+            for (std::size_t column = 0; column < captionIconCount;
+                 ++column) {
+                const Cell &cell = cells[row * captionIconCount + column];
+                stream << "        {" << cell.x << ", " << cell.y << ", "
+                       << cell.width << ", " << cell.height << "},\n";
+            }
+            stream << "    }},\n";
+        }
+        stream << "}};\n\n"
+               << "// Premultiplied ARGB32 in the byte order of the build "
+                  "machine,\n"
+               << "// width * 4 bytes per line\n"
+               << "alignas(4) extern const unsigned char pixels[];\n\n"
+               << "} // namespace CSD::Internal::Atlas\n";
+    }
+
+    QString source;
+    {
+        auto stream = QTextStream(&source);
+        stream << "// Generated by csd_atlasbaker, do not edit\n"
+               << "#include \"csdatlas.h\"\n\n"
+               << "namespace CSD::Internal::Atlas {\n\n"
+               << "alignas(4) const unsigned char pixels[] = {\n";
+        for (int y = 0; y < atlas.height(); ++y) {
+            const uchar *line = atlas.constScanLine(y);
+            for (int x = 0; x < atlasWidth * 4; x += 16) {
+                stream << "   ";
+                for (int byte = x; byte < std::min(x + 16, atlasWidth * 4);
+                     ++byte) {
+                    stream << ' ' << static_cast<unsigned int>(line[byte])
+                           << ',';
+                }
+                stream << '\n';
+            }
+        }
+        stream << "};\n\n"
+               << "} // namespace CSD::Internal::Atlas\n";
+    }
+
+    const auto outputDirectory = QDir(arguments.at(1));
+    if (!writeFile(outputDirectory.filePath(QStringLiteral("csdatlas.h")),
+                   header) ||
+        !writeFile(outputDirectory.filePath(QStringLiteral("csdatlas.cpp")),
+                   source)) {
+        std::fprintf(stderr, "csd_atlasbaker: could not write the atlas\n");
+        return 1;
+    }
+    return 0;
+}